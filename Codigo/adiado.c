@@ -0,0 +1,72 @@
+// adiado.c
+// fila de trabalho adiado do SO
+// simulador de computador
+// so25b
+
+#include "adiado.h"
+
+void adiado_inicializa(adiado_t *self)
+{
+  for (int tipo = 0; tipo < ADIADO_TIPOS; tipo++) {
+    self->pendente[tipo] = false;
+  }
+  self->n_agendados = 0;
+  self->n_juntados = 0;
+  self->n_executados = 0;
+}
+
+void adiado_agenda(adiado_t *self, int tipo, int prioridade, int dado, int agora)
+{
+  if (tipo < 0 || tipo >= ADIADO_TIPOS) return;
+  self->n_agendados++;
+  if (self->pendente[tipo]) {
+    self->n_juntados++;
+    self->dado[tipo] |= dado;
+    if (prioridade < self->prioridade[tipo]) self->prioridade[tipo] = prioridade;
+    return;
+  }
+  self->pendente[tipo] = true;
+  self->prioridade[tipo] = prioridade;
+  self->dado[tipo] = dado;
+  self->t_agendado[tipo] = agora;
+}
+
+bool adiado_pendente(adiado_t *self, int tipo)
+{
+  if (tipo < 0 || tipo >= ADIADO_TIPOS) return false;
+  return self->pendente[tipo];
+}
+
+bool adiado_tem(adiado_t *self, int prio_max)
+{
+  for (int tipo = 0; tipo < ADIADO_TIPOS; tipo++) {
+    if (self->pendente[tipo] && self->prioridade[tipo] <= prio_max) return true;
+  }
+  return false;
+}
+
+void adiado_envelhece(adiado_t *self, int agora, int espera_max)
+{
+  for (int tipo = 0; tipo < ADIADO_TIPOS; tipo++) {
+    if (self->pendente[tipo] && agora - self->t_agendado[tipo] >= espera_max) {
+      self->prioridade[tipo] = 0;
+    }
+  }
+}
+
+bool adiado_proximo(adiado_t *self, int prio_max, int *ptipo, int *pdado)
+{
+  int escolhido = -1;
+  for (int tipo = 0; tipo < ADIADO_TIPOS; tipo++) {
+    if (!self->pendente[tipo] || self->prioridade[tipo] > prio_max) continue;
+    if (escolhido == -1 || self->prioridade[tipo] < self->prioridade[escolhido]) {
+      escolhido = tipo;
+    }
+  }
+  if (escolhido == -1) return false;
+  self->pendente[escolhido] = false;
+  self->n_executados++;
+  *ptipo = escolhido;
+  *pdado = self->dado[escolhido];
+  return true;
+}
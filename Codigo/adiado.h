@@ -0,0 +1,56 @@
+// adiado.h
+// fila de trabalho adiado do SO
+// simulador de computador
+// so25b
+
+#ifndef ADIADO_H
+#define ADIADO_H
+
+// O tratamento de uma interrupção é dividido em duas partes: a de cima, feita
+//   na hora, só confirma o dispositivo e agenda o trabalho; a de baixo, o
+//   trabalho agendado, é feita mais tarde, em pontos escolhidos pelo SO.
+// Cada tipo de trabalho (um inteiro entre 0 e ADIADO_TIPOS-1, definido por
+//   quem usa) fica pendente uma vez só: agendar um trabalho que já está
+//   pendente junta os dois pedidos, com o OU dos dados e a maior das
+//   prioridades. Menor valor é maior prioridade.
+// A estrutura não tem ponteiros, e pode ser copiada (num instantâneo).
+
+#include <stdbool.h>
+
+// número máximo de tipos de trabalho
+#define ADIADO_TIPOS 8
+
+typedef struct {
+  bool pendente[ADIADO_TIPOS];
+  int prioridade[ADIADO_TIPOS];
+  int dado[ADIADO_TIPOS];
+  int t_agendado[ADIADO_TIPOS];  // quando foi agendado (o primeiro pedido)
+  // contadores, para as métricas
+  int n_agendados;
+  int n_juntados;                // pedidos juntados a um já pendente
+  int n_executados;
+} adiado_t;
+
+// inicializa sem trabalho pendente
+void adiado_inicializa(adiado_t *self);
+
+// agenda o trabalho 'tipo', com a prioridade e o dado, no instante 'agora'
+void adiado_agenda(adiado_t *self, int tipo, int prioridade, int dado, int agora);
+
+// retorna true se o trabalho 'tipo' está pendente
+bool adiado_pendente(adiado_t *self, int tipo);
+
+// retorna true se há trabalho pendente com prioridade pelo menos 'prio_max'
+//   (valor menor ou igual)
+bool adiado_tem(adiado_t *self, int prio_max);
+
+// o trabalho que está pendente desde antes de 'agora - espera_max' passa a
+//   ter a maior prioridade (0), para não ser adiado para sempre
+void adiado_envelhece(adiado_t *self, int agora, int espera_max);
+
+// retira o trabalho pendente de maior prioridade, se ela for pelo menos
+//   'prio_max' (valor menor ou igual), e coloca o tipo e o dado em *ptipo e
+//   *pdado; retorna false se não houver
+bool adiado_proximo(adiado_t *self, int prio_max, int *ptipo, int *pdado);
+
+#endif // ADIADO_H
@@ -0,0 +1,318 @@
+// analisa_rastro.c
+// análise offline do rastro de acessos à memória
+// simulador de computador
+// so25b
+
+// Lê um arquivo gerado pelo simulador com a opção '-r' (ver rastro.h) e
+//   calcula:
+// - o número de acessos de cada tipo
+// - o tamanho do conjunto de trabalho (número de páginas distintas
+//   acessadas) em cada janela de tempo
+// - a distribuição da distância de reuso (número de páginas distintas
+//   acessadas entre dois acessos à mesma página, ou distância na pilha LRU)
+// - a pegada de cada processo (número de endereços e páginas distintos
+//   acessados por ele)
+// O tempo é medido em número de acessos.
+
+// ---------------------------------------------------------------------
+// INCLUDES {{{1
+// ---------------------------------------------------------------------
+
+#include "rastro.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+
+// ---------------------------------------------------------------------
+// PARÂMETROS {{{1
+// ---------------------------------------------------------------------
+
+int tam_pagina = 10;      // tamanho de uma página, em palavras
+int tam_janela = 10000;   // tamanho da janela do conjunto de trabalho
+char *nome_rastro;        // arquivo a analisar
+
+// número de faixas no histograma de distância de reuso (potências de 2)
+#define N_FAIXAS 24
+
+
+// ---------------------------------------------------------------------
+// AUXILIARES {{{1
+// ---------------------------------------------------------------------
+
+// aborta o programa com uma mensagem de erro
+void erro_brabo(char *msg)
+{
+  fprintf(stderr, "ERRO FATAL: %s\n", msg);
+  exit(1);
+}
+
+void *aloca_zerado(long n, long tam)
+{
+  void *p = calloc(n, tam);
+  if (p == NULL) erro_brabo("memória insuficiente");
+  return p;
+}
+
+// lê todo o rastro para a memória, retorna o número de registros
+long le_rastro(char *nome, rastro_registro_t **pregs)
+{
+  FILE *arq = fopen(nome, "rb");
+  if (arq == NULL) erro_brabo("não foi possível abrir o arquivo de rastro");
+
+  rastro_cabecalho_t cab;
+  if (fread(&cab, sizeof(cab), 1, arq) != 1
+      || cab.magico != RASTRO_MAGICO || cab.versao != RASTRO_VERSAO) {
+    erro_brabo("o arquivo não contém um rastro válido");
+  }
+  fseek(arq, 0, SEEK_END);
+  long n = (ftell(arq) - (long)sizeof(cab)) / sizeof(rastro_registro_t);
+  fseek(arq, sizeof(cab), SEEK_SET);
+
+  rastro_registro_t *regs = aloca_zerado(n > 0 ? n : 1, sizeof(*regs));
+  n = fread(regs, sizeof(*regs), n, arq);
+  fclose(arq);
+
+  *pregs = regs;
+  return n;
+}
+
+// faixa do histograma para uma distância (0 -> 0, 1 -> 1, 2-3 -> 2, 4-7 -> 3...)
+int faixa(long dist)
+{
+  int f = 0;
+  while (dist > 0 && f < N_FAIXAS - 1) {
+    dist >>= 1;
+    f++;
+  }
+  return f;
+}
+
+
+// ---------------------------------------------------------------------
+// ÁRVORE DE FENWICK {{{1
+// ---------------------------------------------------------------------
+
+// usada para contar quantos instantes estão marcados em um intervalo de
+//   tempo; um instante é marcado se for o último acesso a alguma página,
+//   então a contagem entre dois acessos a uma página é a distância de reuso
+
+long fw_tam;
+int *fw;
+
+void fw_soma(long i, int v)
+{
+  for (i++; i <= fw_tam; i += i & -i) fw[i] += v;
+}
+
+long fw_prefixo(long i)  // soma de [0, i]
+{
+  long s = 0;
+  for (i++; i > 0; i -= i & -i) s += fw[i];
+  return s;
+}
+
+
+// ---------------------------------------------------------------------
+// ANÁLISES {{{1
+// ---------------------------------------------------------------------
+
+void analisa_tipos(rastro_registro_t *regs, long n)
+{
+  static char *nomes[N_RASTRO_ACESSO] = {
+    [RASTRO_BUSCA] = "busca", [RASTRO_LEITURA] = "leitura",
+    [RASTRO_ESCRITA] = "escrita",
+  };
+  long cont[N_RASTRO_ACESSO][2] = { { 0 } };
+  for (long i = 0; i < n; i++) {
+    if (regs[i].tipo < N_RASTRO_ACESSO && regs[i].modo < 2) {
+      cont[regs[i].tipo][regs[i].modo]++;
+    }
+  }
+  printf("--- acessos (%ld) ---\n", n);
+  printf("%-8s %12s %12s\n", "tipo", "supervisor", "usuario");
+  for (int t = 0; t < N_RASTRO_ACESSO; t++) {
+    printf("%-8s %12ld %12ld\n", nomes[t], cont[t][0], cont[t][1]);
+  }
+}
+
+void analisa_conjunto_de_trabalho(rastro_registro_t *regs, long n, int n_pag)
+{
+  // janela em que cada página foi vista pela última vez
+  long *vista = aloca_zerado(n_pag, sizeof(*vista));
+  for (int p = 0; p < n_pag; p++) vista[p] = -1;
+
+  printf("--- conjunto de trabalho (janela de %d acessos, páginas de %d) ---\n",
+         tam_janela, tam_pagina);
+  int max = 0;
+  long soma = 0;
+  long n_janelas = 0;
+  int paginas = 0;
+  for (long i = 0; i < n; i++) {
+    long janela = i / tam_janela;
+    int pag = regs[i].endereco / tam_pagina;
+    if (vista[pag] != janela) {
+      vista[pag] = janela;
+      paginas++;
+    }
+    if ((i + 1) % tam_janela == 0 || i == n - 1) {
+      printf("[%10ld] %6d páginas\n", janela * tam_janela, paginas);
+      if (paginas > max) max = paginas;
+      soma += paginas;
+      n_janelas++;
+      paginas = 0;
+    }
+  }
+  if (n_janelas > 0) {
+    printf("médio: %.1f páginas  máximo: %d páginas (%d palavras)\n",
+           (double)soma / n_janelas, max, max * tam_pagina);
+  }
+  free(vista);
+}
+
+void analisa_reuso(rastro_registro_t *regs, long n, int n_pag)
+{
+  long *ultimo = aloca_zerado(n_pag, sizeof(*ultimo));
+  for (int p = 0; p < n_pag; p++) ultimo[p] = -1;
+  fw_tam = n;
+  fw = aloca_zerado(n + 1, sizeof(*fw));
+
+  long hist[N_FAIXAS] = { 0 };
+  long frios = 0;  // primeiro acesso à página (distância infinita)
+  for (long i = 0; i < n; i++) {
+    int pag = regs[i].endereco / tam_pagina;
+    if (ultimo[pag] < 0) {
+      frios++;
+    } else {
+      long dist = fw_prefixo(i - 1) - fw_prefixo(ultimo[pag]);
+      hist[faixa(dist)]++;
+      fw_soma(ultimo[pag], -1);
+    }
+    fw_soma(i, 1);
+    ultimo[pag] = i;
+  }
+
+  printf("--- distância de reuso (em páginas distintas) ---\n");
+  printf("%-16s %12s\n", "distância", "acessos");
+  for (int f = 0; f < N_FAIXAS; f++) {
+    if (hist[f] == 0) continue;
+    long ini = f == 0 ? 0 : 1L << (f - 1);
+    long fim = f == 0 ? 0 : (1L << f) - 1;
+    printf("%6ld - %-7ld %12ld\n", ini, fim, hist[f]);
+  }
+  printf("%-16s %12ld\n", "infinita", frios);
+  free(fw);
+  free(ultimo);
+}
+
+void analisa_pegada(rastro_registro_t *regs, long n, int max_end)
+{
+  // pids vão de RASTRO_SEM_PID (-1) até o maior encontrado
+  int max_pid = RASTRO_SEM_PID;
+  for (long i = 0; i < n; i++) {
+    if (regs[i].pid > max_pid) max_pid = regs[i].pid;
+  }
+  int n_pids = max_pid + 2;
+  int n_pag = max_end / tam_pagina + 1;
+  long *acessos = aloca_zerado(n_pids, sizeof(*acessos));
+  long *enderecos = aloca_zerado(n_pids, sizeof(*enderecos));
+  long *paginas = aloca_zerado(n_pids, sizeof(*paginas));
+  // marca de quem já acessou cada endereço e página
+  bool *viu_end = aloca_zerado((long)n_pids * (max_end + 1), sizeof(bool));
+  bool *viu_pag = aloca_zerado((long)n_pids * n_pag, sizeof(bool));
+
+  for (long i = 0; i < n; i++) {
+    int p = regs[i].pid + 1;
+    int end = regs[i].endereco;
+    int pag = end / tam_pagina;
+    acessos[p]++;
+    if (!viu_end[(long)p * (max_end + 1) + end]) {
+      viu_end[(long)p * (max_end + 1) + end] = true;
+      enderecos[p]++;
+    }
+    if (!viu_pag[(long)p * n_pag + pag]) {
+      viu_pag[(long)p * n_pag + pag] = true;
+      paginas[p]++;
+    }
+  }
+
+  printf("--- pegada por processo ---\n");
+  printf("%-6s %12s %10s %8s\n", "pid", "acessos", "endereços", "páginas");
+  for (int p = 0; p < n_pids; p++) {
+    if (acessos[p] == 0) continue;
+    if (p == 0) {
+      printf("%-6s", "SO");
+    } else {
+      printf("%-6d", p - 1);
+    }
+    printf(" %12ld %10ld %8ld\n", acessos[p], enderecos[p], paginas[p]);
+  }
+  free(acessos);
+  free(enderecos);
+  free(paginas);
+  free(viu_end);
+  free(viu_pag);
+}
+
+
+// ---------------------------------------------------------------------
+// MAIN {{{1
+// ---------------------------------------------------------------------
+
+int pega_num(int argc, char *argv[argc], int argi)
+{
+  if (argi >= argc || atoi(argv[argi]) < 1) {
+    fprintf(stderr, "ERRO: falta valor positivo após '%s'\n", argv[argi - 1]);
+    exit(1);
+  }
+  return atoi(argv[argi]);
+}
+
+void verifica_args(int argc, char *argv[argc])
+{
+  for (int argi = 1; argi < argc; argi++) {
+    if (strcmp(argv[argi], "-p") == 0) {
+      argi++;
+      tam_pagina = pega_num(argc, argv, argi);
+    } else if (strcmp(argv[argi], "-j") == 0) {
+      argi++;
+      tam_janela = pega_num(argc, argv, argi);
+    } else {
+      nome_rastro = argv[argi];
+    }
+  }
+  if (nome_rastro == NULL) {
+    fprintf(stderr, "ERRO: chame como '%s [-p tam_pagina] [-j tam_janela] "
+                    "arquivo_de_rastro'\n", argv[0]);
+    exit(1);
+  }
+}
+
+int main(int argc, char *argv[argc])
+{
+  verifica_args(argc, argv);
+
+  rastro_registro_t *regs;
+  long n = le_rastro(nome_rastro, &regs);
+
+  int max_end = 0;
+  for (long i = 0; i < n; i++) {
+    if (regs[i].endereco < 0) erro_brabo("endereço negativo no rastro");
+    // a pegada indexa por pid + 1
+    if (regs[i].pid < RASTRO_SEM_PID) erro_brabo("pid inválido no rastro");
+    if (regs[i].endereco > max_end) max_end = regs[i].endereco;
+  }
+  int n_pag = max_end / tam_pagina + 1;
+
+  analisa_tipos(regs, n);
+  analisa_conjunto_de_trabalho(regs, n, n_pag);
+  analisa_reuso(regs, n, n_pag);
+  analisa_pegada(regs, n, max_end);
+
+  free(regs);
+  return 0;
+}
+
+// vim: foldmethod=marker
@@ -0,0 +1,111 @@
+// bench_interrupcao.c
+// custo do tratador de interrupção em assembly, por interrupção
+// simulador de computador
+// so25b
+
+// Carrega o tratador de interrupção (trata_int.maq) e um programa de usuário
+//   que só fica em laço, e interrompe a CPU várias vezes, com um SO que não
+//   faz nada (retorna 0, para voltar ao mesmo processo). Mede quantas
+//   instruções a CPU executa por interrupção, do desvio para o tratador até o
+//   RETI, e o tempo por interrupção.
+// Para comparar com outro tratador, passe o nome do .maq (montado no
+//   endereço CPU_END_TRATADOR).
+// Chame como './bench_interrupcao [tratador.maq [interrupcoes]]'.
+
+#include "cpu.h"
+#include "memoria.h"
+#include "es.h"
+#include "programa.h"
+#include "instrucao.h"
+#include "console.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define END_PROGRAMA 100
+
+// a CPU escreve na console, que não existe aqui
+int console_printf(char *fmt, ...)
+{
+  return 0;
+}
+
+static double agora(void)
+{
+  return (double)clock() / CLOCKS_PER_SEC;
+}
+
+// o "SO": conta as chamadas e volta para o processo interrompido
+static int so_nulo(void *arg, int irq)
+{
+  int *chamadas = arg;
+  (*chamadas)++;
+  return 0;
+}
+
+static void carrega_tratador(mem_t *mem, char *nome)
+{
+  programa_t *prog = prog_cria(nome);
+  if (prog == NULL) {
+    fprintf(stderr, "ERRO: não consegui ler '%s'\n", nome);
+    exit(1);
+  }
+  if (prog_end_carga(prog) != CPU_END_TRATADOR || prog_carrega(prog, mem) != ERR_OK) {
+    fprintf(stderr, "ERRO: '%s' não é carregável em %d\n", nome, CPU_END_TRATADOR);
+    exit(1);
+  }
+  prog_destroi(prog);
+}
+
+int main(int argc, char *argv[argc])
+{
+  char *nome = argc > 1 ? argv[1] : "trata_int.maq";
+  int n = argc > 2 ? atoi(argv[2]) : 1000000;
+  if (n < 1) {
+    fprintf(stderr, "ERRO: chame como '%s [tratador.maq [interrupcoes]]'\n", argv[0]);
+    return 1;
+  }
+
+  mem_t *mem = mem_cria(END_PROGRAMA + 2);
+  es_t *es = es_cria();
+  cpu_t *cpu = cpu_cria(mem, es);
+  int chamadas = 0;
+  cpu_define_chamaC(cpu, so_nulo, &chamadas);
+  carrega_tratador(mem, nome);
+
+  // o programa de usuário é um laço infinito; para chegar nele em modo
+  //   usuário, a CPU começa executando um RETI com o estado do programa na
+  //   memória
+  mem_escreve(mem, END_PROGRAMA, DESV);
+  mem_escreve(mem, END_PROGRAMA + 1, END_PROGRAMA);
+  mem_escreve(mem, CPU_END_RESET, RETI);
+  mem_escreve(mem, CPU_END_PC, END_PROGRAMA);
+  cpu_executa_1(cpu);
+
+  // a CPU só aceita a interrupção seguinte depois que o tratador executou o
+  //   RETI, então as instruções executadas entre duas aceitações são as do
+  //   tratador; a primeira é aceita direto, e o tratador da última não é
+  //   medido
+  long instrucoes = 0;
+  double t0 = agora();
+  for (int i = 0; i <= n; i++) {
+    while (!cpu_interrompe(cpu, IRQ_RELOGIO)) {
+      cpu_executa_1(cpu);
+      instrucoes++;
+    }
+  }
+  double t1 = agora();
+  if (chamadas != n) {
+    fprintf(stderr, "ERRO: o SO foi chamado %d vezes em %d interrupções\n", chamadas, n);
+    return 1;
+  }
+
+  printf("%s: %d interrupções, %.2f instruções e %.1f ns por interrupção\n",
+         nome, n, (double)instrucoes / n, (t1 - t0) * 1e9 / n);
+
+  cpu_destroi(cpu);
+  es_destroi(es);
+  mem_destroi(mem);
+  return 0;
+}
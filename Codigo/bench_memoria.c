@@ -0,0 +1,128 @@
+// bench_memoria.c
+// comparação das operações em bloco da memória com laços de mem_le/mem_escreve
+// simulador de computador
+// so25b
+
+// Para cada operação em bloco (mem_preenche, mem_copia, mem_compara e
+//   mem_checksum), mede o tempo de executar a operação várias vezes sobre
+//   uma região da memória, e o tempo de fazer a mesma coisa com um laço
+//   que acessa uma palavra por vez com mem_le/mem_escreve (que é como o
+//   SO fazia). Confere também se os resultados são os mesmos.
+// Chame como './bench_memoria [tamanho_da_regiao [repeticoes]]'.
+// Para medir a versão AVX2, compile com "make CFLAGS='-Wall -Werror -O2 -mavx2'".
+
+#include "memoria.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double agora(void)
+{
+  return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static void imprime(char *nome, double t_bloco, double t_palavra)
+{
+  printf("%-10s bloco %8.4fs  palavra %8.4fs  ganho %6.1fx\n",
+         nome, t_bloco, t_palavra, t_bloco > 0 ? t_palavra / t_bloco : 0);
+}
+
+static void confere(int ok, char *nome)
+{
+  if (!ok) {
+    fprintf(stderr, "ERRO: resultado de %s não confere\n", nome);
+    exit(1);
+  }
+}
+
+// versões com uma palavra por vez, usando as operações básicas
+
+static void palavra_preenche(mem_t *mem, int end, int n, int valor)
+{
+  for (int i = 0; i < n; i++) mem_escreve(mem, end + i, valor);
+}
+
+static void palavra_copia(mem_t *mem, int end, int *origem, int n)
+{
+  for (int i = 0; i < n; i++) mem_escreve(mem, end + i, origem[i]);
+}
+
+static int palavra_compara(mem_t *mem, int end, int *dados, int n)
+{
+  for (int i = 0; i < n; i++) {
+    int v;
+    mem_le(mem, end + i, &v);
+    if (v != dados[i]) return i;
+  }
+  return -1;
+}
+
+static unsigned int palavra_checksum(mem_t *mem, int end, int n)
+{
+  unsigned int s1 = 0, s2 = 0;
+  for (int i = 0; i < n; i++) {
+    int v;
+    mem_le(mem, end + i, &v);
+    s1 += v;
+    s2 += s1;
+  }
+  return s1 ^ ((s2 << 16) | (s2 >> 16));
+}
+
+int main(int argc, char *argv[argc])
+{
+  int tam = argc > 1 ? atoi(argv[1]) : 10000;
+  int rep = argc > 2 ? atoi(argv[2]) : 2000;
+  if (tam < 1 || rep < 1) {
+    fprintf(stderr, "ERRO: chame como '%s [tamanho [repeticoes]]'\n", argv[0]);
+    return 1;
+  }
+
+  mem_t *mem = mem_cria(tam + 1);
+  int *dados = malloc(tam * sizeof(*dados));
+  for (int i = 0; i < tam; i++) dados[i] = rand();
+
+  printf("região de %d palavras, %d repetições\n", tam, rep);
+  double t0, t1, t2;
+  // usa o endereço 1, para os acessos não ficarem alinhados
+  int end = 1;
+
+  t0 = agora();
+  for (int r = 0; r < rep; r++) mem_preenche(mem, end, tam, r);
+  t1 = agora();
+  for (int r = 0; r < rep; r++) palavra_preenche(mem, end, tam, r);
+  t2 = agora();
+  imprime("preenche", t1 - t0, t2 - t1);
+
+  t0 = agora();
+  for (int r = 0; r < rep; r++) mem_copia(mem, end, dados, tam);
+  t1 = agora();
+  for (int r = 0; r < rep; r++) palavra_copia(mem, end, dados, tam);
+  t2 = agora();
+  imprime("copia", t1 - t0, t2 - t1);
+
+  // altera a última palavra, para as comparações percorrerem tudo
+  dados[tam - 1]++;
+  int dif_b = 0, dif_p = 0;
+  t0 = agora();
+  for (int r = 0; r < rep; r++) mem_compara(mem, end, dados, tam, &dif_b);
+  t1 = agora();
+  for (int r = 0; r < rep; r++) dif_p = palavra_compara(mem, end, dados, tam);
+  t2 = agora();
+  imprime("compara", t1 - t0, t2 - t1);
+  confere(dif_b == dif_p && dif_b == tam - 1, "compara");
+
+  unsigned int soma_b = 0, soma_p = 0;
+  t0 = agora();
+  for (int r = 0; r < rep; r++) mem_checksum(mem, end, tam, &soma_b);
+  t1 = agora();
+  for (int r = 0; r < rep; r++) soma_p = palavra_checksum(mem, end, tam);
+  t2 = agora();
+  imprime("checksum", t1 - t0, t2 - t1);
+  confere(soma_b == soma_p, "checksum");
+
+  free(dados);
+  mem_destroi(mem);
+  return 0;
+}
@@ -0,0 +1,122 @@
+// bench_processos.c
+// custo das operações da tabela de processos com o número de processos
+// simulador de computador
+// so25b
+
+// Para tabelas com cada vez mais processos, mede o tempo por operação de
+//   criar um processo (tp_aloca), buscar pelo pid (tp_busca), matar e criar
+//   outro no lugar (tp_libera + tp_aloca, como acontece com os pids sempre
+//   crescentes do SO) e matar todos. O tempo por operação deve ficar
+//   aproximadamente constante.
+// Para comparação, mede também a busca percorrendo os processos, que é
+//   como o SO encontrava um processo pelo pid.
+// Chame como './bench_processos [max_processos]'.
+
+#include "tabela_proc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// número de buscas lineares em cada medida (são caras com muitos processos)
+#define BUSCAS_LINEARES 1000
+
+static double agora(void)
+{
+  return (double)clock() / CLOCKS_PER_SEC;
+}
+
+// tempo por operação, em ns
+static double ns(double t, int n)
+{
+  return t * 1e9 / n;
+}
+
+static void confere(int ok, char *nome)
+{
+  if (!ok) {
+    fprintf(stderr, "ERRO: resultado de %s não confere\n", nome);
+    exit(1);
+  }
+}
+
+// busca percorrendo os processos
+static processo_t *busca_linear(tabela_proc_t *tabela, int id)
+{
+  for (processo_t *proc = tp_primeiro(tabela); proc != NULL; proc = tp_proximo(proc)) {
+    if (proc->id == id) return proc;
+  }
+  return NULL;
+}
+
+static void mede(int n)
+{
+  tabela_proc_t *tabela = tp_cria();
+  processo_t **procs = malloc(n * sizeof(*procs));
+  int *ids = malloc(n * sizeof(*ids));
+  double t0, t1;
+
+  t0 = agora();
+  for (int i = 0; i < n; i++) procs[i] = tp_aloca(tabela, i);
+  t1 = agora();
+  double t_cria = ns(t1 - t0, n);
+  confere(tp_n(tabela) == n, "cria");
+
+  for (int i = 0; i < n; i++) ids[i] = rand() % n;
+  int achados = 0;
+  t0 = agora();
+  for (int i = 0; i < n; i++) achados += tp_busca(tabela, ids[i]) == procs[ids[i]];
+  t1 = agora();
+  double t_busca = ns(t1 - t0, n);
+  confere(achados == n, "busca");
+
+  achados = 0;
+  t0 = agora();
+  for (int i = 0; i < BUSCAS_LINEARES; i++) {
+    achados += busca_linear(tabela, ids[i % n]) == procs[ids[i % n]];
+  }
+  t1 = agora();
+  double t_linear = ns(t1 - t0, BUSCAS_LINEARES);
+  confere(achados == BUSCAS_LINEARES, "busca linear");
+
+  // troca cada processo por um novo, com pid ainda não usado
+  t0 = agora();
+  for (int i = 0; i < n; i++) {
+    tp_libera(tabela, procs[i]);
+    procs[i] = tp_aloca(tabela, n + i);
+  }
+  t1 = agora();
+  double t_troca = ns(t1 - t0, n);
+  confere(tp_n(tabela) == n && tp_busca(tabela, 0) == NULL
+          && tp_busca(tabela, 2 * n - 1) == procs[n - 1], "troca");
+
+  t0 = agora();
+  for (int i = 0; i < n; i++) tp_libera(tabela, procs[i]);
+  t1 = agora();
+  double t_mata = ns(t1 - t0, n);
+  confere(tp_n(tabela) == 0, "mata");
+
+  printf("%8d %10.1f %10.1f %10.1f %10.1f %14.1f\n",
+         n, t_cria, t_busca, t_troca, t_mata, t_linear);
+
+  free(ids);
+  free(procs);
+  tp_destroi(tabela);
+}
+
+int main(int argc, char *argv[argc])
+{
+  int max = argc > 1 ? atoi(argv[1]) : 100000;
+  if (max < 1) {
+    fprintf(stderr, "ERRO: chame como '%s [max_processos]'\n", argv[0]);
+    return 1;
+  }
+
+  printf("tempo por operação, em ns\n");
+  printf("%8s %10s %10s %10s %10s %14s\n",
+         "procs", "cria", "busca", "troca", "mata", "busca linear");
+  for (int n = 1000; n <= max; n *= 10) {
+    mede(n);
+  }
+  return 0;
+}
@@ -0,0 +1,106 @@
+// bench_roda.c
+// custo das operações da roda de tempo com o número de processos dormindo
+// simulador de computador
+// so25b
+
+// Para rodas com cada vez mais nós (os processos em SO_DORME), com
+//   vencimentos sorteados em até MAX_ESPERA instantes, mede o tempo por nó
+//   de inserir (roda_insere), de retirar antes de vencer (roda_retira, como
+//   quando um processo dormindo morre) e de avançar a roda até todos
+//   vencerem (roda_vence), conferindo que vencem em ordem. O tempo por
+//   operação deve ficar aproximadamente constante.
+// Chame como './bench_roda [max_nos]'.
+
+#include "roda.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// vencimentos entre 1 e MAX_ESPERA instantes depois do início
+#define MAX_ESPERA 100000
+
+static double agora(void)
+{
+  return (double)clock() / CLOCKS_PER_SEC;
+}
+
+// tempo por operação, em ns
+static double ns(double t, int n)
+{
+  return t * 1e9 / n;
+}
+
+static void confere(int ok, char *nome)
+{
+  if (!ok) {
+    fprintf(stderr, "ERRO: resultado de %s não confere\n", nome);
+    exit(1);
+  }
+}
+
+static void insere_todos(roda_t *roda, no_roda_t *nos, int *expira, int n)
+{
+  for (int i = 0; i < n; i++) roda_insere(roda, &nos[i], expira[i]);
+}
+
+static void mede(int n)
+{
+  roda_t *roda = malloc(sizeof(*roda));
+  no_roda_t *nos = malloc(n * sizeof(*nos));
+  int *expira = malloc(n * sizeof(*expira));
+  double t0, t1;
+
+  roda_inicializa(roda, 0);
+  for (int i = 0; i < n; i++) {
+    roda_inicializa_no(&nos[i]);
+    expira[i] = 1 + rand() % MAX_ESPERA;
+  }
+
+  t0 = agora();
+  insere_todos(roda, nos, expira, n);
+  t1 = agora();
+  double t_insere = ns(t1 - t0, n);
+  confere(roda_n(roda) == n, "insere");
+
+  t0 = agora();
+  for (int i = 0; i < n; i++) roda_retira(roda, &nos[i]);
+  t1 = agora();
+  double t_retira = ns(t1 - t0, n);
+  confere(roda_n(roda) == 0, "retira");
+
+  insere_todos(roda, nos, expira, n);
+  int vencidos = 0, ultimo = 0, em_ordem = 1;
+  t0 = agora();
+  no_roda_t *no;
+  while ((no = roda_vence(roda, MAX_ESPERA)) != NULL) {
+    if (no->expira < ultimo || no->expira != roda->agora) em_ordem = 0;
+    ultimo = no->expira;
+    vencidos++;
+  }
+  t1 = agora();
+  double t_vence = ns(t1 - t0, n);
+  confere(vencidos == n && em_ordem && roda_n(roda) == 0, "vence");
+
+  printf("%8d %10.1f %10.1f %10.1f\n", n, t_insere, t_retira, t_vence);
+
+  free(expira);
+  free(nos);
+  free(roda);
+}
+
+int main(int argc, char *argv[argc])
+{
+  int max = argc > 1 ? atoi(argv[1]) : 1000000;
+  if (max < 1) {
+    fprintf(stderr, "ERRO: chame como '%s [max_nos]'\n", argv[0]);
+    return 1;
+  }
+
+  printf("tempo por nó, em ns (vencimentos em até %d instantes)\n", MAX_ESPERA);
+  printf("%8s %10s %10s %10s\n", "nós", "insere", "retira", "vence");
+  for (int n = 1000; n <= max; n *= 10) {
+    mede(n);
+  }
+  return 0;
+}
@@ -57,6 +57,7 @@ struct console_t {
   char txt_console[N_LIN_CONSOLE][N_COL+1];
   char txt_entrada[N_COL+1];
   char fila_de_comandos_externos[N_CMD_EXT];
+  char pedido_escalonador[N_COL+1];
   FILE *arquivo_de_log;
 };
 
@@ -87,6 +88,7 @@ console_t *console_cria(void)
   }
   strcpy(self->txt_entrada, "");
   self->fila_de_comandos_externos[0] = '\0';
+  strcpy(self->pedido_escalonador, "");
   self->arquivo_de_log = fopen("log_da_console", "w");
 
   tela_init();
@@ -236,6 +238,14 @@ static char remove_comando_externo(console_t *self)
   return cmd;
 }
 
+bool console_pedido_escalonador(console_t *self, char *nome, int tam)
+{
+  if (self->pedido_escalonador[0] == '\0') return false;
+  snprintf(nome, tam, "%s", self->pedido_escalonador);
+  strcpy(self->pedido_escalonador, "");
+  return true;
+}
+
 static void interpreta_linha_entrada(console_t *self)
 {
   // interpreta uma linha digitada pelo operador
@@ -243,9 +253,11 @@ static void interpreta_linha_entrada(console_t *self)
   // Etstr entra a string 'str' no terminal 't'  ex: eb30
   // Zt    esvazia a saída do terminal 't'  ex: za
   // Dn    altera o tempo de espera do teclado  ex: d0  -> modo turbo
+  // Snome troca o escalonador do SO  ex: sround_robin
   // P     para a execução
   // 1     executa uma instrução
   // C     continua a execução
+  // V     volta ao instantâneo anterior
   // F     fim da simulação
 
   char *linha = self->txt_entrada;
@@ -263,9 +275,13 @@ static void interpreta_linha_entrada(console_t *self)
       val = atoi(&linha[1]);
       tela_espera(val);
       break;
+    case 'S':
+      strcpy(self->pedido_escalonador, &linha[1]);
+      break;
     case 'P':
     case '1':
     case 'C':
+    case 'V':
     case 'F':
       insere_comando_externo(self, cmd);
       break;
@@ -343,7 +359,7 @@ static void desenha_console(console_t *self)
 
 static void desenha_entrada(console_t *self)
 {
-  char txt_fixo[] = "P=para C=continua 1=passo F=fim  Ets=entra Zt=zera";
+  char txt_fixo[] = "P=para C=continua 1=passo V=volta F=fim  Ets=entra Zt=zera Sn=escal";
   tela_posiciona(LINHA_ENTRADA, 0);
   tela_puts(COR_ENTRADA, ""); // gambiarra para limpar na cor certa
   tela_limpa_linha();
@@ -30,10 +30,16 @@ void console_print_status(console_t *self, char *txt);
 //   'P': para a execução,
 //   '1': executa uma instrução,
 //   'C': continua a execução,
+//   'V': volta ao instantâneo anterior,
 //   'F': finaliza a simulação.
 // retorna '\0' caso não tenha comando externo digitado
 char console_comando_externo(console_t *self);
 
+// se o operador pediu a troca do escalonador do SO (comando 'S'), copia o
+//   nome pedido para 'nome' (com até 'tam' bytes) e retorna true; cada pedido
+//   é retornado uma vez
+bool console_pedido_escalonador(console_t *self, char *nome, int tam);
+
 // retorna o terminal identificado ('A', 'B', etc)
 terminal_t *console_terminal(console_t *self, char id_terminal);
 
@@ -10,19 +10,27 @@
 #include <stdio.h>
 #include <assert.h>
 
+// intervalo entre instantâneos
+#define INTERVALO_INSTANTANEO 100000   // em instruções executadas
+
 struct controle_t {
   cpu_t *cpu;
   relogio_t *relogio;
   console_t *console;
+  pic_t *pic;
   enum { executando, passo, parado, fim } estado;
+  instantaneo_t *inst;
+  int prox_instantaneo;   // quando tirar o próximo instantâneo
 };
 
 // funções auxiliares
 static void controle_processa_comandos_da_console(controle_t *self);
 static void controle_atualiza_estado_na_console(controle_t *self);
+static void controle_verifica_instantaneo(controle_t *self);
 
 
-controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio)
+controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio,
+                          pic_t *pic)
 {
   controle_t *self = malloc(sizeof(*self));
   assert(self != NULL);
@@ -30,16 +38,55 @@ controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio)
   self->cpu = cpu;
   self->console = console;
   self->relogio = relogio;
+  self->pic = pic;
   self->estado = parado;
+  self->inst = NULL;
+  self->prox_instantaneo = 0;
 
   return self;
 }
 
+void controle_define_instantaneo(controle_t *self, instantaneo_t *inst)
+{
+  self->inst = inst;
+}
+
 void controle_destroi(controle_t *self)
 {
   free(self);
 }
 
+// passa para o PIC os pedidos de interrupção dos dispositivos, e para a
+//   CPU a interrupção escolhida pelo PIC
+// a CPU só aceita uma interrupção por vez; as outras ficam pendentes no PIC
+//   e são entregues depois de uma próxima instrução (ou atendidas junto pelo
+//   SO)
+static void controle_interrupcoes(controle_t *self)
+{
+  // o dispositivo 3 do relógio contém 1 se o timer expirou
+  int tem_int;
+  relogio_leitura(self->relogio, 3, &tem_int);
+  if (tem_int != 0) {
+    pic_pede(self->pic, IRQ_RELOGIO);
+    relogio_escrita(self->relogio, 3, 0);
+  }
+  for (char id = 'A'; id <= 'D'; id++) {
+    terminal_t *terminal = console_terminal(self->console, id);
+    irq_t irq;
+    while (terminal_pede_interrupcao(terminal, &irq)) {
+      pic_pede(self->pic, irq);
+      terminal_interrupcao_aceita(terminal, irq);
+    }
+  }
+
+  irq_t irq;
+  int end_tratador;
+  if (pic_interrupcao(self->pic, &irq, &end_tratador)
+      && cpu_interrompe_vetor(self->cpu, irq, end_tratador)) {
+    pic_aceita(self->pic, irq);
+  }
+}
+
 void controle_laco(controle_t *self)
 {
   // executa uma instrução por vez até a console dizer que chega
@@ -47,16 +94,11 @@ void controle_laco(controle_t *self)
     if (self->estado == passo || self->estado == executando) {
       cpu_executa_1(self->cpu);
       relogio_tictac(self->relogio);
+      controle_verifica_instantaneo(self);
 
       if (self->estado == passo) self->estado = parado;
 
-      // enquanto não tem controlador de interrupção, fala direto com o relógio
-      // o dispositivo 3 do relógio contém 1 se o timer expirou
-      int tem_int;
-      relogio_leitura(self->relogio, 3, &tem_int);
-      if (tem_int != 0) {
-        cpu_interrompe(self->cpu, IRQ_RELOGIO);
-      }
+      controle_interrupcoes(self);
     }
     console_tictac(self->console);
 
@@ -68,6 +110,39 @@ void controle_laco(controle_t *self)
 }
  
 
+// tira um instantâneo, se for a hora
+static void controle_verifica_instantaneo(controle_t *self)
+{
+  if (self->inst == NULL) return;
+  int agora;
+  relogio_leitura(self->relogio, 0, &agora);
+  if (agora >= self->prox_instantaneo) {
+    instantaneo_tira(self->inst, agora);
+    self->prox_instantaneo = agora + INTERVALO_INSTANTANEO;
+  }
+}
+
+// volta para o último instantâneo anterior ao momento atual, e para a execução
+static void controle_volta_no_tempo(controle_t *self)
+{
+  if (self->inst == NULL) return;
+  int agora;
+  relogio_leitura(self->relogio, 0, &agora);
+  int tempo = instantaneo_volta(self->inst, agora);
+  if (tempo == -1) {
+    console_printf("Não há instantâneo anterior a %d", agora);
+    return;
+  }
+  if (tempo == -2) {
+    console_printf("Não foi possível voltar para antes de %d", agora);
+    return;
+  }
+  console_printf("Voltou de %d para %d (%d instantâneos)", agora, tempo,
+                 instantaneo_quantos(self->inst));
+  self->prox_instantaneo = tempo + INTERVALO_INSTANTANEO;
+  self->estado = parado;
+}
+
 static void controle_processa_comandos_da_console(controle_t *self)
 {
   char cmd = console_comando_externo(self->console);
@@ -84,6 +159,9 @@ static void controle_processa_comandos_da_console(controle_t *self)
     case 'C':
       self->estado = executando;
       break;
+    case 'V':
+      controle_volta_no_tempo(self);
+      break;
   }
 }
 
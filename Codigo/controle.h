@@ -11,10 +11,17 @@ typedef struct controle_t controle_t;
 #include "cpu.h"
 #include "console.h"
 #include "relogio.h"
+#include "pic.h"
+#include "instantaneo.h"
 
-controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio);
+controle_t *controle_cria(cpu_t *cpu, console_t *console, relogio_t *relogio,
+                          pic_t *pic);
 void controle_destroi(controle_t *self);
 
+// define o gerenciador de instantâneos; o controlador tira um instantâneo
+//   periodicamente e volta para o anterior quando o operador pede
+void controle_define_instantaneo(controle_t *self, instantaneo_t *inst);
+
 // o laço principal da simulação
 void controle_laco(controle_t *self);
 
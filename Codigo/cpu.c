@@ -44,6 +44,8 @@ struct cpu_t {
   // função e argumento para implementar instrução CHAMAC
   func_chamaC_t func_chamaC;
   void *arg_chamaC;
+  // rastro dos acessos à memória (NULL se não estiver rastreando)
+  rastro_t *rastro;
 };
 
 
@@ -69,6 +71,7 @@ cpu_t *cpu_cria(mem_t *mem, es_t *es)
   self->complemento = 0;
   self->modo = supervisor;
   self->func_chamaC = NULL;
+  self->rastro = NULL;
 
   // inicializa instruções privilegiadas
   memset(self->privilegiadas, 0, sizeof(self->privilegiadas)); // todos em false
@@ -93,6 +96,32 @@ void cpu_define_chamaC(cpu_t *self, func_chamaC_t func_chamaC, void *arg_chamaC)
   self->arg_chamaC = arg_chamaC;
 }
 
+void cpu_define_rastro(cpu_t *self, rastro_t *rastro)
+{
+  self->rastro = rastro;
+}
+
+
+// ---------------------------------------------------------------------
+// INSTANTÂNEOS {{{1
+// ---------------------------------------------------------------------
+
+// o estado é a estrutura inteira; os ponteiros para memória, E/S etc
+//   continuam válidos, porque o estado só é recuperado na mesma CPU
+void *cpu_salva(void *self)
+{
+  cpu_t *copia = malloc(sizeof(*copia));
+  assert(copia != NULL);
+  memcpy(copia, self, sizeof(*copia));
+  return copia;
+}
+
+bool cpu_restaura(void *self, void *estado)
+{
+  memcpy(self, estado, sizeof(cpu_t));
+  return true;
+}
+
 
 // ---------------------------------------------------------------------
 // DESCRIÇÃO {{{1
@@ -154,8 +183,9 @@ void cpu_concatena_descricao(cpu_t *self, char *str)
 // funções auxiliares para usar durante a execução das instruções
 // alteram o estado da CPU caso ocorra erro
 
-// lê um valor da memória
-static bool pega_mem(cpu_t *self, int endereco, int *pval)
+// lê um valor da memória, registrando no rastro o tipo do acesso
+static bool pega_mem_rastro(cpu_t *self, int endereco, int *pval,
+                            rastro_acesso_t tipo)
 {
   // não pode acessar memória privilegiada em modo usuário
   if (self->modo == usuario && endereco <= CPU_END_FIM_PROT) {
@@ -163,11 +193,22 @@ static bool pega_mem(cpu_t *self, int endereco, int *pval)
     return false;
   }
   self->erro = mem_le(self->mem, endereco, pval);
-  if (self->erro == ERR_OK) return true;
+  if (self->erro == ERR_OK) {
+    if (self->rastro != NULL) {
+      rastro_registra(self->rastro, endereco, tipo, self->modo);
+    }
+    return true;
+  }
   self->complemento = endereco;
   return false;
 }
 
+// lê um valor da memória
+static bool pega_mem(cpu_t *self, int endereco, int *pval)
+{
+  return pega_mem_rastro(self, endereco, pval, RASTRO_LEITURA);
+}
+
 // escreve um valor na memória
 static bool poe_mem(cpu_t *self, int endereco, int val)
 {
@@ -177,7 +218,12 @@ static bool poe_mem(cpu_t *self, int endereco, int val)
     return false;
   }
   self->erro = mem_escreve(self->mem, endereco, val);
-  if (self->erro == ERR_OK) return true;
+  if (self->erro == ERR_OK) {
+    if (self->rastro != NULL) {
+      rastro_registra(self->rastro, endereco, RASTRO_ESCRITA, self->modo);
+    }
+    return true;
+  }
   self->complemento = endereco;
   return false;
 }
@@ -205,7 +251,7 @@ static bool poe_es(cpu_t *self, int dispositivo, int val)
 static bool pega_opcode(cpu_t *self, int *popc)
 {
   // não pode executar se houver erro na leitura da memória
-  if (!pega_mem(self, self->PC, popc)) return false;
+  if (!pega_mem_rastro(self, self->PC, popc, RASTRO_BUSCA)) return false;
   // pode executar se tiver privilégio para isso
   if (self->modo == supervisor || !self->privilegiadas[*popc]) return true;
   // não pode executar instrução privilegiada em modo usuário
@@ -216,7 +262,7 @@ static bool pega_opcode(cpu_t *self, int *popc)
 // lê o argumento 1 da instrução no PC
 static bool pega_A1(cpu_t *self, int *pA1)
 {
-  return pega_mem(self, self->PC + 1, pA1);
+  return pega_mem_rastro(self, self->PC + 1, pA1, RASTRO_BUSCA);
 }
 
 
@@ -525,6 +571,11 @@ void cpu_executa_1(cpu_t *self)
 // ---------------------------------------------------------------------
 
 bool cpu_interrompe(cpu_t *self, irq_t irq)
+{
+  return cpu_interrompe_vetor(self, irq, CPU_END_TRATADOR);
+}
+
+bool cpu_interrompe_vetor(cpu_t *self, irq_t irq, int end_tratador)
 {
   // só aceita interrupção em modo usuário ou quando a CPU está dormindo
   if (self->modo != usuario && self->erro != ERR_CPU_PARADA) return false;
@@ -532,9 +583,10 @@ bool cpu_interrompe(cpu_t *self, irq_t irq)
 
   // Copia o estado da CPU para variáveis locais, para ter certeza que nada será
   //   alterado por funções auxiliares (poe_mem altera o erro)
-  int PC, A, erro, complemento;
+  int PC, A, X, erro, complemento;
   PC          = self->PC;
   A           = self->A;
+  X           = self->X;
   erro        = self->erro;
   complemento = self->complemento;
 
@@ -543,18 +595,18 @@ bool cpu_interrompe(cpu_t *self, irq_t irq)
   self->modo = supervisor;
 
   // salva todo o estado interno da CPU
-  //   atenção, nem todos os registradores são salvos pelo hardware
   poe_mem(self, CPU_END_PC,          PC);
   poe_mem(self, CPU_END_A,           A);
+  poe_mem(self, CPU_END_X,           X);
   poe_mem(self, CPU_END_erro,        erro);
   poe_mem(self, CPU_END_complemento, complemento);
 
   // altera o estado da CPU para ela poder executar o tratador de interrupção
-  // vai iniciar o tratamento da interrupção no endereço CPU_END_TRATADOR,
+  // vai iniciar o tratamento da interrupção no endereço end_tratador,
   //   com o A contendo o valor da requisição de interrupção e sem erro
   // se o tratador da interrupção precisar do estado da CPU de antes da
   //   interrupção, deve acessar o início da memória, onde esse estado foi salvo
-  self->PC   = CPU_END_TRATADOR;
+  self->PC   = end_tratador;
   self->A    = irq;
   self->erro = ERR_OK;
 
@@ -570,9 +622,10 @@ static void cpu_desinterrompe(cpu_t *self)
   // copia primeiro para variáveis locais, para evitar problemas de tipo (pega_mem
   //   espera int*, mas nem todos os dados são int), e de alteração do estado por
   //   pega_mem
-  int PC, A, erro, complemento;
+  int PC, A, X, erro, complemento;
   pega_mem(self, CPU_END_PC,          &PC);
   pega_mem(self, CPU_END_A,           &A);
+  pega_mem(self, CPU_END_X,           &X);
   pega_mem(self, CPU_END_erro,        &erro);
   pega_mem(self, CPU_END_complemento, &complemento);
 
@@ -580,6 +633,7 @@ static void cpu_desinterrompe(cpu_t *self)
   //   só recupera pelo hardware o que foi salvo pelo hardware
   self->PC          = PC;
   self->A           = A;
+  self->X           = X;
   self->erro        = erro;
   self->complemento = complemento;
   // coloca a CPU em modo usuário
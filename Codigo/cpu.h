@@ -18,6 +18,7 @@ typedef enum { supervisor, usuario } cpu_modo_t;
 #define CPU_END_A           51
 #define CPU_END_erro        52
 #define CPU_END_complemento 53
+#define CPU_END_X           54
 
 // endereço inicial do PC quando o processador é inicializado
 #define CPU_END_RESET        0
@@ -33,6 +34,7 @@ typedef enum { supervisor, usuario } cpu_modo_t;
 #include "memoria.h"
 #include "es.h"
 #include "irq.h"
+#include "rastro.h"
 
 // tipo da função a ser chamada quando executar a instrução CHAMAC
 typedef int (*func_chamaC_t)(void *argC, int reg_A);
@@ -58,10 +60,22 @@ void cpu_executa_1(cpu_t *self);
 // retorna true se interrupção foi aceita ou false caso contrário
 bool cpu_interrompe(cpu_t *self, irq_t irq);
 
+// como cpu_interrompe, mas desvia para o tratador no endereço end_tratador
+//   em vez de CPU_END_TRATADOR (para interrupções vetoradas, ver pic.h)
+bool cpu_interrompe_vetor(cpu_t *self, irq_t irq, int end_tratador);
+
 // define a função a chamar quando executar a instrução CHAMAC
 // e o argumento a passar para ela (normalmente, um ponteiro para o SO)
 void cpu_define_chamaC(cpu_t *self, func_chamaC_t func, void *argC);
 
+// define o rastro onde registrar os acessos à memória (NULL para não registrar)
+void cpu_define_rastro(cpu_t *self, rastro_t *rastro);
+
+// funções para salvar e recuperar o estado da CPU em um instantâneo
+//   (seguem o protocolo f_salva_t e f_restaura_t de instantaneo.h)
+void *cpu_salva(void *self);
+bool cpu_restaura(void *self, void *estado);
+
 // concatena a descrição do estado da CPU no final de str
 void cpu_concatena_descricao(cpu_t *self, char *str);
 
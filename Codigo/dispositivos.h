@@ -7,6 +7,7 @@
 #define DISPOSITIVOS_H
 
 #include "terminal.h"
+#include "pic.h"
 
 typedef enum {
   D_TERM_A,
@@ -33,6 +34,15 @@ typedef enum {
   D_RELOGIO_REAL,
   D_RELOGIO_TIMER,
   D_RELOGIO_INTERRUPCAO,
+  D_PIC,
+  D_PIC_PENDENTES         =  D_PIC + PIC_PENDENTES,
+  D_PIC_EM_SERVICO        =  D_PIC + PIC_EM_SERVICO,
+  D_PIC_MASCARA           =  D_PIC + PIC_MASCARA,
+  D_PIC_ACK               =  D_PIC + PIC_ACK,
+  D_PIC_EOI               =  D_PIC + PIC_EOI,
+  D_PIC_PRIORIDADE        =  D_PIC + PIC_PRIORIDADE,  // + irq
+  D_PIC_VETOR             =  D_PIC + PIC_VETOR,       // + irq
+  D_PIC_FIM               =  D_PIC + PIC_N_DISP - 1,
   N_DISPOSITIVOS
 } dispositivo_id_t;
 
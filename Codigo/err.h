@@ -16,6 +16,7 @@ typedef enum {
   ERR_DISP_INV,      // dispositivo inválido
   ERR_OCUP,          // dispositivo ocupado
   ERR_INSTR_PRIV,    // instrução privilegiada
+  ERR_ESCR_PROT,     // escrita em página protegida
   N_ERR              // número de erros
 } err_t;
 
@@ -0,0 +1,128 @@
+// esc_grupos.c
+// política de escalonamento justo em dois níveis: a cpu é dividida
+//   igualmente entre os grupos de processos (ver SO_CRIA_PROC), e a de cada
+//   grupo entre os seus processos; como no escalonador justo, cada grupo e
+//   cada processo acumulam um tempo virtual (as instruções executadas), e
+//   executa o processo de menor tempo virtual do grupo de menor tempo virtual
+// assim um grupo que cria muitos processos não tira cpu dos outros grupos
+// simulador de computador
+// so25b
+
+#include "escalonador.h"
+
+// período (em interrupções do relógio) no qual todos os grupos com processos
+//   prontos devem executar, e fatia mínima de cada um
+#define LATENCIA_GRUPOS 20
+#define FATIA_MIN_GRUPOS 2
+// quanto tempo virtual (em instruções) um grupo ou processo que chega pode
+//   estar atrás do menor já escalonado
+#define CREDITO_MAX_GRUPOS 500
+
+// a entrada do grupo do processo, ou NULL se o grupo não tiver processos
+//   prontos
+static esc_grupo_t *grupo(escalonador_t *self, processo_t *proc)
+{
+  return mapa_busca(self->mapa_grupos, proc->grupo);
+}
+
+static void insere(escalonador_t *self, processo_t *proc)
+{
+  esc_grupo_t *g = grupo(self, proc);
+  if (g == NULL) {
+    // o grupo que volta a ter prontos começa no menor tempo virtual, como um
+    //   processo que chega no justo
+    g = slab_aloca(self->grupos);
+    if (g == NULL) return;
+    if (!mapa_insere(self->mapa_grupos, proc->grupo, g)) {
+      slab_libera(self->grupos, g);
+      return;
+    }
+    g->id = proc->grupo;
+    g->n = 0;
+    g->vruntime = self->vruntime_min;
+    g->vruntime_min = proc->vruntime;
+    heap_inicializa(&g->prontos);
+    heap_inicializa_no(&g->no_heap);
+    heap_insere(&self->heap_grupos, &g->no_heap, g->vruntime);
+  }
+  if (proc->vruntime < g->vruntime_min - CREDITO_MAX_GRUPOS) {
+    proc->vruntime = g->vruntime_min - CREDITO_MAX_GRUPOS;
+  }
+  heap_insere(&g->prontos, &proc->no_heap, proc->vruntime);
+  g->n++;
+}
+
+static void retira(escalonador_t *self, processo_t *proc)
+{
+  if (!proc->no_heap.no_heap) return;
+  esc_grupo_t *g = grupo(self, proc);
+  heap_retira(&g->prontos, &proc->no_heap);
+  g->n--;
+  if (g->n == 0) {
+    heap_retira(&self->heap_grupos, &g->no_heap);
+    mapa_retira(self->mapa_grupos, g->id);
+    slab_libera(self->grupos, g);
+  }
+}
+
+static processo_t *proximo(escalonador_t *self)
+{
+  no_heap_t *no = heap_menor(&self->heap_grupos);
+  if (no == NULL) return NULL;
+  esc_grupo_t *g = HEAP_DONO(no, esc_grupo_t, no_heap);
+  if (g->vruntime > self->vruntime_min) self->vruntime_min = g->vruntime;
+  processo_t *proc = HEAP_DONO(heap_menor(&g->prontos), processo_t, no_heap);
+  if (proc->vruntime > g->vruntime_min) g->vruntime_min = proc->vruntime;
+  return proc;
+}
+
+// a latência dividida entre os grupos com prontos, mas não menos que a
+//   fatia mínima
+static int fatia(escalonador_t *self)
+{
+  int n = heap_n(&self->heap_grupos);
+  int fatia = LATENCIA_GRUPOS / (n > 0 ? n : 1);
+  return fatia < FATIA_MIN_GRUPOS ? FATIA_MIN_GRUPOS : fatia;
+}
+
+static void escolhido(escalonador_t *self, processo_t *proc)
+{
+  proc->quantum = fatia(self);
+}
+
+// as instruções contam para o processo e para o seu grupo
+static void executou(escalonador_t *self, processo_t *proc, int n)
+{
+  esc_grupo_t *g = grupo(self, proc);
+  proc->vruntime += n;
+  if (g == NULL) return;
+  g->vruntime += n;
+  // as chaves nos heaps mudaram, recoloca
+  if (proc->no_heap.no_heap) {
+    heap_retira(&g->prontos, &proc->no_heap);
+    heap_insere(&g->prontos, &proc->no_heap, proc->vruntime);
+  }
+  heap_retira(&self->heap_grupos, &g->no_heap);
+  heap_insere(&self->heap_grupos, &g->no_heap, g->vruntime);
+}
+
+// ao fim da fatia o processo volta a disputar a cpu
+static void tique(escalonador_t *self, processo_t *corrente)
+{
+  if (corrente == NULL) return;
+  corrente->quantum--;
+  if (corrente->quantum <= 0) {
+    corrente->quantum = fatia(self);
+    self->troca = true;
+  }
+}
+
+const esc_ops_t esc_grupos = {
+  .nome = "grupos",
+  .insere = insere,
+  .retira = retira,
+  .proximo = proximo,
+  .escolhido = escolhido,
+  .executou = executou,
+  .tique = tique,
+};
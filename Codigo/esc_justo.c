@@ -0,0 +1,84 @@
+// esc_justo.c
+// política de escalonamento justo: cada processo acumula um tempo virtual
+//   (as instruções que executou), e executa o de menor tempo virtual, por uma
+//   fatia que diminui com o número de processos prontos
+// simulador de computador
+// so25b
+
+#include "escalonador.h"
+
+// período (em interrupções do relógio) no qual todos os processos prontos
+//   devem executar, e fatia mínima de cada um
+#define LATENCIA_JUSTO 20
+#define FATIA_MIN_JUSTO 2
+// quanto tempo virtual (em instruções) um processo que chega pode estar
+//   atrás do menor já escalonado
+#define CREDITO_MAX_JUSTO 500
+
+static void insere(escalonador_t *self, processo_t *proc)
+{
+  // quem chega (novo ou desbloqueado) não pode ter vruntime muito menor que
+  //   os demais, senão monopoliza a cpu
+  if (proc->vruntime < self->vruntime_min - CREDITO_MAX_JUSTO) {
+    proc->vruntime = self->vruntime_min - CREDITO_MAX_JUSTO;
+  }
+  heap_insere(&self->heap, &proc->no_heap, proc->vruntime);
+}
+
+static void retira(escalonador_t *self, processo_t *proc)
+{
+  heap_retira(&self->heap, &proc->no_heap);
+}
+
+static processo_t *proximo(escalonador_t *self)
+{
+  no_heap_t *no = heap_menor(&self->heap);
+  if (no == NULL) return NULL;
+  processo_t *proc = HEAP_DONO(no, processo_t, no_heap);
+  if (proc->vruntime > self->vruntime_min) self->vruntime_min = proc->vruntime;
+  return proc;
+}
+
+// a latência dividida entre os prontos, mas não menos que a fatia mínima
+static int fatia(escalonador_t *self)
+{
+  int n = heap_n(&self->heap);
+  int fatia = LATENCIA_JUSTO / (n > 0 ? n : 1);
+  return fatia < FATIA_MIN_JUSTO ? FATIA_MIN_JUSTO : fatia;
+}
+
+static void escolhido(escalonador_t *self, processo_t *proc)
+{
+  proc->quantum = fatia(self);
+}
+
+static void executou(escalonador_t *self, processo_t *proc, int n)
+{
+  proc->vruntime += n;
+  // a chave no heap mudou, recoloca
+  if (proc->no_heap.no_heap) {
+    heap_retira(&self->heap, &proc->no_heap);
+    heap_insere(&self->heap, &proc->no_heap, proc->vruntime);
+  }
+}
+
+// ao fim da fatia o processo volta a disputar a cpu
+static void tique(escalonador_t *self, processo_t *corrente)
+{
+  if (corrente == NULL) return;
+  corrente->quantum--;
+  if (corrente->quantum <= 0) {
+    corrente->quantum = fatia(self);
+    self->troca = true;
+  }
+}
+
+const esc_ops_t esc_justo = {
+  .nome = "justo",
+  .insere = insere,
+  .retira = retira,
+  .proximo = proximo,
+  .escolhido = escolhido,
+  .executou = executou,
+  .tique = tique,
+};
@@ -0,0 +1,154 @@
+// esc_loteria.c
+// política de escalonamento por loteria: a cada quantum sorteia um bilhete
+//   entre os dos processos prontos; cada processo recebe em média uma fração
+//   da cpu proporcional aos seus bilhetes (ver SO_BILHETES)
+// simulador de computador
+// so25b
+
+#include "escalonador.h"
+#include "console.h"
+
+#include <stdlib.h>
+
+static void insere(escalonador_t *self, processo_t *proc)
+{
+  fp_insere(&self->fila, proc, ESC_NIVEL_PADRAO);
+}
+
+static void retira(escalonador_t *self, processo_t *proc)
+{
+  fp_retira(&self->fila, proc);
+}
+
+// sorteia um dos processos prontos, com chance proporcional aos bilhetes
+// usa um gerador próprio (congruencial linear) para que a semente faça parte
+//   do estado do escalonador, e a execução seja repetida igual depois de
+//   voltar a um instantâneo
+static processo_t *proximo(escalonador_t *self)
+{
+  int total = 0;
+  for (processo_t *p = self->fila.ini[ESC_NIVEL_PADRAO]; p != NULL; p = p->fp_prox) {
+    total += p->bilhetes;
+  }
+  if (total == 0) return NULL;
+  self->semente = self->semente * 1103515245 + 12345;
+  int sorteado = (self->semente >> 8) % total;
+  for (processo_t *p = self->fila.ini[ESC_NIVEL_PADRAO]; p != NULL; p = p->fp_prox) {
+    sorteado -= p->bilhetes;
+    if (sorteado < 0) return p;
+  }
+  return NULL;
+}
+
+// ao fim do quantum, sorteia de novo
+static void tique(escalonador_t *self, processo_t *corrente)
+{
+  if (corrente == NULL) return;
+  if (--corrente->quantum <= 0) {
+    corrente->quantum = QUANTUM_INICIAL;
+    self->troca = true;
+  }
+}
+
+// criação ou morte de um processo, para a varredura de fatia_media
+typedef struct {
+  int t;
+  int i;          // índice do processo
+  bool morte;
+} evento_t;
+
+static int compara_eventos(const void *a, const void *b)
+{
+  const evento_t *ea = a, *eb = b;
+  if (ea->t != eb->t) return ea->t < eb->t ? -1 : 1;
+  // no mesmo instante, quem morre sai antes de quem nasce entrar
+  return eb->morte - ea->morte;
+}
+
+// calcula em fatia[i] a média, ao longo da vida do processo i, de peso[i]
+//   sobre a soma dos pesos dos processos vivos em cada instante
+// varre as criações e mortes em ordem acumulando F(t), a integral de
+//   1/(soma dos pesos vivos); a fatia é peso[i] * (F(morte)-F(criação)) / vida
+// processos ainda vivos ou com peso 0 ficam com fatia 0
+// retorna false se faltar memória
+static bool fatia_media(Historicos *h, double *peso, double *fatia)
+{
+  evento_t *ev = malloc(2 * h->n * sizeof(*ev));
+  double *f_criacao = malloc(h->n * sizeof(*f_criacao));
+  if (ev == NULL || f_criacao == NULL) {
+    free(ev);
+    free(f_criacao);
+    return false;
+  }
+  int n_ev = 0;
+  for (int i = 0; i < h->n; i++) {
+    Historico_processos *p = hst_busca(h, i);
+    fatia[i] = 0;
+    if (p->t_morte < 0 || peso[i] <= 0) continue;
+    ev[n_ev++] = (evento_t){ p->t_criacao, i, false };
+    ev[n_ev++] = (evento_t){ p->t_morte, i, true };
+  }
+  qsort(ev, n_ev, sizeof(*ev), compara_eventos);
+
+  double soma = 0, integral = 0;
+  int t_ant = n_ev > 0 ? ev[0].t : 0;
+  for (int k = 0; k < n_ev; k++) {
+    if (soma > 0) integral += (ev[k].t - t_ant) / soma;
+    t_ant = ev[k].t;
+    int i = ev[k].i;
+    if (ev[k].morte) {
+      soma -= peso[i];
+      Historico_processos *p = hst_busca(h, i);
+      int vida = p->t_morte - p->t_criacao;
+      // sem duração, conta só quem estava vivo no mesmo instante
+      fatia[i] = vida > 0 ? peso[i] * (integral - f_criacao[i]) / vida
+                          : peso[i] / (soma + peso[i]);
+    } else {
+      soma += peso[i];
+      f_criacao[i] = integral;
+    }
+  }
+  free(f_criacao);
+  free(ev);
+  return true;
+}
+
+// compara a fração da cpu configurada (bilhetes do processo sobre o total)
+//   com a obtida (taxa de progresso do processo sobre a soma das taxas, o que
+//   desconta o tempo bloqueado); as duas somas são sobre os processos vivos
+//   ao mesmo tempo, em média ao longo da vida de cada processo; usada também
+//   pela política passada
+void esc_metricas_bilhetes(escalonador_t *self, Historicos *h)
+{
+  double *bilhetes = malloc(h->n * sizeof(*bilhetes));
+  double *taxa = malloc(h->n * sizeof(*taxa));
+  double *configurada = malloc(h->n * sizeof(*configurada));
+  double *obtida = malloc(h->n * sizeof(*obtida));
+  if (bilhetes != NULL && taxa != NULL && configurada != NULL && obtida != NULL) {
+    for (int i = 0; i < h->n; i++) {
+      Historico_processos *p = hst_busca(h, i);
+      bilhetes[i] = p->bilhetes;
+      taxa[i] = p->t_executavel > 0 ? (double)p->instrucoes / p->t_executavel : 0;
+    }
+    if (fatia_media(h, bilhetes, configurada) && fatia_media(h, taxa, obtida)) {
+      for (int i = 0; i < h->n; i++) {
+        Historico_processos *p = hst_busca(h, i);
+        console_printf("Processo %d: %d bilhetes, fatia configurada %.1f%%, obtida %.1f%%",
+                       p->id, p->bilhetes, 100 * configurada[i], 100 * obtida[i]);
+      }
+    }
+  }
+  free(obtida);
+  free(configurada);
+  free(taxa);
+  free(bilhetes);
+}
+
+const esc_ops_t esc_loteria = {
+  .nome = "loteria",
+  .insere = insere,
+  .retira = retira,
+  .proximo = proximo,
+  .tique = tique,
+  .metricas = esc_metricas_bilhetes,
+};
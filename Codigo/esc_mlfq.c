@@ -0,0 +1,112 @@
+// esc_mlfq.c
+// política de escalonamento com filas em vários níveis e realimentação
+//   (multilevel feedback queue): o quantum é maior nos níveis mais baixos; o
+//   processo desce de nível quando usa todo o seu quantum, sobe quando
+//   bloqueia esperando o terminal, e periodicamente todos voltam ao nível
+//   mais alto
+// simulador de computador
+// so25b
+
+#include "escalonador.h"
+#include "console.h"
+
+// quantum (em interrupções do relógio) de cada nível
+static const int quantum_mlfq[ESC_NIVEIS_MLFQ] = { 2, 4, 8, 16 };
+// a cada quantas interrupções todos voltam ao nível 0
+#define PERIODO_ENVELHECIMENTO_MLFQ 100
+
+// muda o processo de nível, com o quantum do novo nível, e o coloca no fim
+//   da fila do novo nível se estiver pronto
+static void muda_nivel(escalonador_t *self, processo_t *proc, int nivel)
+{
+  proc->nivel_mlfq = nivel;
+  proc->quantum = quantum_mlfq[nivel];
+  if (fp_contem(&self->fila, proc)) {
+    fp_retira(&self->fila, proc);
+    fp_insere(&self->fila, proc, nivel);
+  }
+}
+
+static void cria(escalonador_t *self, processo_t *proc)
+{
+  proc->nivel_mlfq = 0;
+  proc->quantum = quantum_mlfq[0];
+}
+
+static void insere(escalonador_t *self, processo_t *proc)
+{
+  fp_insere(&self->fila, proc, proc->nivel_mlfq);
+}
+
+static void retira(escalonador_t *self, processo_t *proc)
+{
+  fp_retira(&self->fila, proc);
+}
+
+static processo_t *proximo(escalonador_t *self)
+{
+  return fp_primeiro(&self->fila);
+}
+
+// o processo que bloqueia esperando o terminal (interativo) sobe um nível;
+//   esperar outro processo ou dormir não conta como E/S
+static void bloqueia(escalonador_t *self, processo_t *proc, motivo_bloqueio motivo)
+{
+  if (motivo != bloq_terminal || proc->nivel_mlfq == 0) return;
+  muda_nivel(self, proc, proc->nivel_mlfq - 1);
+  self->mlfq_promocoes++;
+}
+
+// rebaixa o corrente se usou todo o quantum, envelhece periodicamente e
+//   contabiliza a ocupação dos níveis
+static void tique(escalonador_t *self, processo_t *corrente)
+{
+  if (corrente != NULL && --corrente->quantum <= 0) {
+    int nivel = corrente->nivel_mlfq;
+    if (nivel < ESC_NIVEIS_MLFQ - 1) {
+      nivel++;
+      self->mlfq_rebaixamentos++;
+    }
+    // mesmo no último nível, vai para o fim da fila
+    fp_retira(&self->fila, corrente);
+    muda_nivel(self, corrente, nivel);
+    fp_insere(&self->fila, corrente, nivel);
+    self->troca = true;
+  }
+
+  self->mlfq_tiques++;
+  if (self->mlfq_tiques % PERIODO_ENVELHECIMENTO_MLFQ == 0) {
+    for (processo_t *proc = tp_primeiro(self->tabela); proc != NULL; proc = tp_proximo(proc)) {
+      if (proc->estado != morto && proc->tr.periodo == 0 && proc->nivel_mlfq != 0) {
+        muda_nivel(self, proc, 0);
+        self->mlfq_envelhecimentos++;
+      }
+    }
+  }
+  for (int n = 0; n < ESC_NIVEIS_MLFQ; n++) {
+    self->mlfq_ocupacao[n] += fp_n_nivel(&self->fila, n);
+  }
+}
+
+static void metricas(escalonador_t *self, Historicos *h)
+{
+  if (self->mlfq_tiques == 0) return;
+  console_printf("MLFQ: %d rebaixamentos, %d promocoes, %d envelhecimentos",
+                 self->mlfq_rebaixamentos, self->mlfq_promocoes, self->mlfq_envelhecimentos);
+  for (int n = 0; n < ESC_NIVEIS_MLFQ; n++) {
+    console_printf("MLFQ nivel %d (quantum %d): %.2f prontos em media", n, quantum_mlfq[n],
+                   (double)self->mlfq_ocupacao[n] / self->mlfq_tiques);
+  }
+}
+
+const esc_ops_t esc_mlfq = {
+  .nome = "mlfq",
+  .preemptiva = true,
+  .cria = cria,
+  .insere = insere,
+  .retira = retira,
+  .proximo = proximo,
+  .tique = tique,
+  .bloqueia = bloqueia,
+  .metricas = metricas,
+};
@@ -0,0 +1,58 @@
+// esc_passada.c
+// política de escalonamento por passada (stride): versão determinística da
+//   loteria; cada processo avança uma passada inversamente proporcional aos
+//   seus bilhetes a cada instrução executada, e executa o de menor passada
+// simulador de computador
+// so25b
+
+#include "escalonador.h"
+
+static void insere(escalonador_t *self, processo_t *proc)
+{
+  // como no justo, quem chega não pode estar muito atrás dos demais
+  if (proc->passada < self->passada_min) proc->passada = self->passada_min;
+  heap_insere(&self->heap, &proc->no_heap, proc->passada);
+}
+
+static void retira(escalonador_t *self, processo_t *proc)
+{
+  heap_retira(&self->heap, &proc->no_heap);
+}
+
+static processo_t *proximo(escalonador_t *self)
+{
+  no_heap_t *no = heap_menor(&self->heap);
+  if (no == NULL) return NULL;
+  processo_t *proc = HEAP_DONO(no, processo_t, no_heap);
+  if (proc->passada > self->passada_min) self->passada_min = proc->passada;
+  return proc;
+}
+
+static void executou(escalonador_t *self, processo_t *proc, int n)
+{
+  proc->passada += (long long)n * proc->passo;
+  if (proc->no_heap.no_heap) {
+    heap_retira(&self->heap, &proc->no_heap);
+    heap_insere(&self->heap, &proc->no_heap, proc->passada);
+  }
+}
+
+// ao fim do quantum, o de menor passada passa a executar
+static void tique(escalonador_t *self, processo_t *corrente)
+{
+  if (corrente == NULL) return;
+  if (--corrente->quantum <= 0) {
+    corrente->quantum = QUANTUM_INICIAL;
+    self->troca = true;
+  }
+}
+
+const esc_ops_t esc_passada = {
+  .nome = "passada",
+  .insere = insere,
+  .retira = retira,
+  .proximo = proximo,
+  .executou = executou,
+  .tique = tique,
+  .metricas = esc_metricas_bilhetes,
+};
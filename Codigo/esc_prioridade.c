@@ -0,0 +1,65 @@
+// esc_prioridade.c
+// política de escalonamento por prioridade: a fila é ordenada pela
+//   prioridade (0 é a maior), e quando o processo corrente usa todo o seu
+//   quantum a prioridade é recalculada com a fração do quantum usada, e ele
+//   volta para a fila
+// simulador de computador
+// so25b
+
+#include "escalonador.h"
+
+// nível da fila de prontos para uma prioridade entre 0 (maior) e 1 (menor)
+static int nivel(float prio)
+{
+  return prio * (FP_N_NIVEIS - 1);
+}
+
+// nova prioridade: média entre a anterior e a fração do quantum usada
+static float calcula_prioridade(processo_t *proc)
+{
+  int t_exec = QUANTUM_INICIAL - proc->quantum;
+  return (proc->prio + (float)t_exec / QUANTUM_INICIAL) / 2;
+}
+
+static void insere(escalonador_t *self, processo_t *proc)
+{
+  fp_insere(&self->fila, proc, nivel(proc->prio));
+}
+
+static void retira(escalonador_t *self, processo_t *proc)
+{
+  fp_retira(&self->fila, proc);
+}
+
+static processo_t *proximo(escalonador_t *self)
+{
+  return fp_primeiro(&self->fila);
+}
+
+static void tique(escalonador_t *self, processo_t *corrente)
+{
+  if (corrente == NULL) return;
+  corrente->quantum--;
+  if (corrente->quantum > 0) return;
+  corrente->prio = calcula_prioridade(corrente);
+  corrente->quantum = QUANTUM_INICIAL;
+  fp_retira(&self->fila, corrente);
+  fp_insere(&self->fila, corrente, nivel(corrente->prio));
+  self->troca = true;
+}
+
+// quem bloqueia antes do fim do quantum melhora a prioridade
+static void bloqueia(escalonador_t *self, processo_t *proc, motivo_bloqueio motivo)
+{
+  proc->prio = calcula_prioridade(proc);
+  proc->quantum = QUANTUM_INICIAL;
+}
+
+const esc_ops_t esc_prioridade = {
+  .nome = "prioridade",
+  .insere = insere,
+  .retira = retira,
+  .proximo = proximo,
+  .tique = tique,
+  .bloqueia = bloqueia,
+};
@@ -0,0 +1,44 @@
+// esc_round_robin.c
+// política de escalonamento circular: como a simples, mas quando o processo
+//   corrente usa todo o seu quantum ele vai para o fim da fila
+// simulador de computador
+// so25b
+
+#include "escalonador.h"
+
+static void insere(escalonador_t *self, processo_t *proc)
+{
+  fp_insere(&self->fila, proc, ESC_NIVEL_PADRAO);
+}
+
+static void retira(escalonador_t *self, processo_t *proc)
+{
+  fp_retira(&self->fila, proc);
+}
+
+static processo_t *proximo(escalonador_t *self)
+{
+  return fp_primeiro(&self->fila);
+}
+
+static void tique(escalonador_t *self, processo_t *corrente)
+{
+  if (corrente == NULL) return;
+  corrente->quantum--;
+  if (corrente->quantum > 0) return;
+  corrente->quantum = QUANTUM_INICIAL;
+  // se tem mais alguém pronto, vai para o fim da fila
+  if (fp_n(&self->fila) > 1) {
+    fp_retira(&self->fila, corrente);
+    fp_insere(&self->fila, corrente, ESC_NIVEL_PADRAO);
+    self->troca = true;
+  }
+}
+
+const esc_ops_t esc_round_robin = {
+  .nome = "round_robin",
+  .insere = insere,
+  .retira = retira,
+  .proximo = proximo,
+  .tique = tique,
+};
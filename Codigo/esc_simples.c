@@ -0,0 +1,29 @@
+// esc_simples.c
+// política de escalonamento simples: o processo corrente executa até
+//   bloquear ou morrer, e então executa o primeiro da fila
+// simulador de computador
+// so25b
+
+#include "escalonador.h"
+
+static void insere(escalonador_t *self, processo_t *proc)
+{
+  fp_insere(&self->fila, proc, ESC_NIVEL_PADRAO);
+}
+
+static void retira(escalonador_t *self, processo_t *proc)
+{
+  fp_retira(&self->fila, proc);
+}
+
+static processo_t *proximo(escalonador_t *self)
+{
+  return fp_primeiro(&self->fila);
+}
+
+const esc_ops_t esc_simples = {
+  .nome = "simples",
+  .insere = insere,
+  .retira = retira,
+  .proximo = proximo,
+};
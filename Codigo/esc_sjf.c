@@ -0,0 +1,110 @@
+// esc_sjf.c
+// políticas de escalonamento pelo menor surto de cpu previsto: a previsão é
+//   a média exponencial dos surtos anteriores (em instruções, entre o
+//   despacho e o bloqueio ou preempção)
+// sjf: executa o de menor previsão até ele bloquear
+// srtf: troca de processo quando chega um com menos cpu prevista que o que
+//   resta ao processo corrente
+// simulador de computador
+// so25b
+
+#include "escalonador.h"
+#include "console.h"
+
+#include <stdlib.h>
+
+// peso (em 1/8) do último surto na nova previsão
+#define PESO_SURTO_SJF 4
+
+// chave no heap: no sjf, a previsão do surto; no srtf, o que falta dela (se
+//   o surto já passou da previsão, supõe que vai durar o dobro, senão nunca
+//   mais seria preemptado)
+static int chave(escalonador_t *self, processo_t *proc)
+{
+  if (self->ops == &esc_sjf) return proc->surto_previsto;
+  int previsto = proc->surto_previsto > 0 ? proc->surto_previsto : 1;
+  while (previsto <= proc->t_cpu) {
+    previsto *= 2;
+  }
+  return previsto - proc->t_cpu;
+}
+
+static void recoloca(escalonador_t *self, processo_t *proc)
+{
+  if (proc->no_heap.no_heap) {
+    heap_retira(&self->heap, &proc->no_heap);
+    heap_insere(&self->heap, &proc->no_heap, chave(self, proc));
+  }
+}
+
+static void insere(escalonador_t *self, processo_t *proc)
+{
+  heap_insere(&self->heap, &proc->no_heap, chave(self, proc));
+}
+
+static void retira(escalonador_t *self, processo_t *proc)
+{
+  heap_retira(&self->heap, &proc->no_heap);
+}
+
+static processo_t *proximo(escalonador_t *self)
+{
+  no_heap_t *no = heap_menor(&self->heap);
+  if (no == NULL) return NULL;
+  return HEAP_DONO(no, processo_t, no_heap);
+}
+
+static void executou(escalonador_t *self, processo_t *proc, int n)
+{
+  proc->t_cpu += n;
+  // no srtf a chave muda com a execução, e o corrente deve ser reavaliado
+  if (self->ops == &esc_srtf) {
+    recoloca(self, proc);
+    self->troca = true;
+  }
+}
+
+// o surto terminou, atualiza a previsão do próximo
+static void deixa_cpu(escalonador_t *self, processo_t *proc)
+{
+  if (proc->t_cpu == 0) return;
+  proc->erro_previsao += abs(proc->surto_previsto - proc->t_cpu);
+  proc->surto_previsto = (PESO_SURTO_SJF * proc->t_cpu
+                          + (8 - PESO_SURTO_SJF) * proc->surto_previsto) / 8;
+  proc->n_exec++;
+  proc->t_cpu = 0;
+  recoloca(self, proc);
+}
+
+// erro médio das previsões
+static void metricas(escalonador_t *self, Historicos *h)
+{
+  for (int i = 0; i < h->n; i++) {
+    Historico_processos *p = hst_busca(h, i);
+    if (p->n_surtos > 0) {
+      console_printf("Processo %d: %d surtos, erro medio da previsao %d instrucoes",
+                     p->id, p->n_surtos, p->erro_previsao / p->n_surtos);
+    }
+  }
+}
+
+const esc_ops_t esc_sjf = {
+  .nome = "sjf",
+  .insere = insere,
+  .retira = retira,
+  .proximo = proximo,
+  .executou = executou,
+  .deixa_cpu = deixa_cpu,
+  .metricas = metricas,
+};
+
+const esc_ops_t esc_srtf = {
+  .nome = "srtf",
+  .preemptiva = true,
+  .insere = insere,
+  .retira = retira,
+  .proximo = proximo,
+  .executou = executou,
+  .deixa_cpu = deixa_cpu,
+  .metricas = metricas,
+};
@@ -0,0 +1,444 @@
+// escalonador.c
+// escalonador de processos, com políticas intercambiáveis
+// simulador de computador
+// so25b
+
+#include "escalonador.h"
+#include "console.h"
+
+#include <string.h>
+
+// ---------------------------------------------------------------------
+// POLÍTICAS {{{1
+// ---------------------------------------------------------------------
+
+// as políticas disponíveis; a primeira é a usada se for pedida uma que não existe
+static const esc_ops_t *politicas[] = {
+  &esc_simples,
+  &esc_round_robin,
+  &esc_prioridade,
+  &esc_justo,
+  &esc_mlfq,
+  &esc_loteria,
+  &esc_passada,
+  &esc_sjf,
+  &esc_srtf,
+  &esc_grupos,
+};
+#define N_POLITICAS (sizeof(politicas) / sizeof(politicas[0]))
+
+const esc_ops_t *esc_busca(char *nome)
+{
+  for (int i = 0; i < N_POLITICAS; i++) {
+    if (strcmp(politicas[i]->nome, nome) == 0) return politicas[i];
+  }
+  return NULL;
+}
+
+void esc_lista(void)
+{
+  char nomes[200] = "";
+  for (int i = 0; i < N_POLITICAS; i++) {
+    strcat(nomes, " ");
+    strcat(nomes, politicas[i]->nome);
+  }
+  console_printf("escalonadores:%s", nomes);
+}
+
+void esc_inicializa(escalonador_t *self, tabela_proc_t *tabela, char *nome)
+{
+  self->ops = esc_busca(nome);
+  if (self->ops == NULL) self->ops = politicas[0];
+  self->tabela = tabela;
+  self->agora = 0;
+  self->tiques = 0;
+  self->n_prontos = 0;
+  self->n_tempo_real = 0;
+  self->n_cotas = 0;
+  self->n_estrangulados = 0;
+  self->troca = false;
+  heap_inicializa(&self->heap_tempo_real);
+  heap_inicializa(&self->heap_liberacao);
+  lista_inicializa(&self->cotas);
+  fp_inicializa(&self->fila);
+  heap_inicializa(&self->heap);
+  self->vruntime_min = 0;
+  self->passada_min = 0;
+  self->semente = 1;
+  for (int i = 0; i < ESC_NIVEIS_MLFQ; i++) {
+    self->mlfq_ocupacao[i] = 0;
+  }
+  self->mlfq_tiques = 0;
+  self->mlfq_rebaixamentos = 0;
+  self->mlfq_promocoes = 0;
+  self->mlfq_envelhecimentos = 0;
+  self->grupos = slab_cria(sizeof(esc_grupo_t));
+  self->mapa_grupos = mapa_cria();
+  heap_inicializa(&self->heap_grupos);
+}
+
+void esc_finaliza(escalonador_t *self)
+{
+  slab_destroi(self->grupos);
+  mapa_destroi(self->mapa_grupos);
+}
+
+// o estado é o tamanho do estado das entradas dos grupos, seguido dele e do
+//   mapa
+
+int esc_tam_estado(escalonador_t *self)
+{
+  return sizeof(int) + slab_tam_estado(self->grupos) + mapa_tam_estado(self->mapa_grupos);
+}
+
+void esc_salva(escalonador_t *self, void *estado)
+{
+  int *tam_slab = estado;
+  *tam_slab = slab_tam_estado(self->grupos);
+  slab_salva(self->grupos, tam_slab + 1);
+  mapa_salva(self->mapa_grupos, (char *)(tam_slab + 1) + *tam_slab);
+}
+
+bool esc_restaura(escalonador_t *self, void *estado)
+{
+  int *tam_slab = estado;
+  // o mapa primeiro, é a única parte que pode falhar
+  if (!mapa_restaura(self->mapa_grupos, (char *)(tam_slab + 1) + *tam_slab)) {
+    return false;
+  }
+  slab_restaura(self->grupos, tam_slab + 1);
+  return true;
+}
+
+char *esc_nome(escalonador_t *self)
+{
+  return self->ops->nome;
+}
+
+void esc_muda_politica(escalonador_t *self, const esc_ops_t *ops)
+{
+  // os processos de tempo real não estão nas estruturas da política
+  for (processo_t *proc = tp_primeiro(self->tabela); proc != NULL; proc = tp_proximo(proc)) {
+    if (proc->estado != morto && proc->tr.periodo == 0) {
+      self->ops->retira(self, proc);
+    }
+  }
+  self->ops = ops;
+  for (processo_t *proc = tp_primeiro(self->tabela); proc != NULL; proc = tp_proximo(proc)) {
+    if (proc->estado == pronto && proc->tr.periodo == 0 && !proc->estrangulado) {
+      self->ops->insere(self, proc);
+    }
+  }
+  self->troca = true;
+}
+
+void esc_define_agora(escalonador_t *self, int agora)
+{
+  self->agora = agora;
+}
+
+
+// ---------------------------------------------------------------------
+// CLASSE DE TEMPO REAL {{{1
+// ---------------------------------------------------------------------
+
+// a cada período é liberado um job do processo, com prazo no fim do período
+// o job termina quando o processo bloqueia, morre ou esgota o orçamento
+// enquanto o job não é liberado, o processo não disputa a cpu
+
+static void libera_job(escalonador_t *self, processo_t *proc)
+{
+  proc->tr.ativo = true;
+  proc->tr.restante = proc->tr.orcamento;
+  proc->tr.prazo = self->tiques + proc->tr.periodo;
+  proc->tr.n_jobs++;
+}
+
+// contabiliza o atraso do job; o próximo só sai no fim do período atual
+static void termina_job(escalonador_t *self, processo_t *proc)
+{
+  if (!proc->tr.ativo) return;
+  proc->tr.ativo = false;
+  proc->tr.liberacao = proc->tr.prazo;
+  int atraso = self->tiques - proc->tr.prazo;
+  int faixa = 0;
+  if (atraso > 0) {
+    proc->tr.n_perdas++;
+    if (atraso > proc->tr.atraso_max) proc->tr.atraso_max = atraso;
+    // faixas 1, 2-3, 4-7, 8+
+    for (faixa = 1; faixa < N_FAIXAS_ATRASO - 1 && atraso >= (1 << faixa); faixa++) {
+      ;
+    }
+  }
+  proc->tr.atrasos[faixa]++;
+}
+
+bool esc_tempo_real(escalonador_t *self, processo_t *proc, int periodo, int orcamento)
+{
+  if (periodo < 0 || (periodo > 0 && (orcamento < 1 || orcamento > periodo))) {
+    return false;
+  }
+
+  // controle de admissão: com EDF, os prazos são cumpridos se a soma das
+  //   frações da cpu pedidas não passar de 1
+  double utilizacao = periodo > 0 ? (double)orcamento / periodo : 0;
+  for (processo_t *p = tp_primeiro(self->tabela); p != NULL; p = tp_proximo(p)) {
+    if (p != proc && p->estado != morto && p->tr.periodo > 0) {
+      utilizacao += (double)p->tr.orcamento / p->tr.periodo;
+    }
+  }
+  if (utilizacao > 1) return false;
+
+  // muda de classe: sai dos prontos da classe atual e entra nos da nova
+  bool estava_pronto = esc_contem(self, proc);
+  esc_retira(self, proc);
+  if ((proc->tr.periodo > 0) != (periodo > 0)) self->n_tempo_real += periodo > 0 ? 1 : -1;
+  proc->tr.periodo = periodo;
+  proc->tr.orcamento = orcamento;
+  proc->tr.ativo = false;
+  proc->tr.liberacao = self->tiques;
+  proc->quantum = QUANTUM_INICIAL;
+  if (estava_pronto) esc_insere(self, proc);
+  return true;
+}
+
+
+// ---------------------------------------------------------------------
+// COTA DE CPU {{{1
+// ---------------------------------------------------------------------
+
+// o processo que esgota a cota fica fora dos prontos (mas no estado pronto)
+//   até a janela seguinte
+
+bool esc_cota(escalonador_t *self, processo_t *proc, int cota)
+{
+  if (cota < 0) return false;
+  if ((proc->cota > 0) != (cota > 0)) self->n_cotas += cota > 0 ? 1 : -1;
+  proc->cota = cota;
+  if (cota > 0) {
+    lista_insere(&self->cotas, &proc->no_cota);
+  } else if (!proc->estrangulado) {
+    lista_retira(&self->cotas, &proc->no_cota);
+  }
+  return true;
+}
+
+// conta as instruções na cota do processo, e o estrangula se esgotou
+static void consome_cota(escalonador_t *self, processo_t *proc, int n)
+{
+  if (proc->cota == 0 || proc->tr.periodo > 0) return;
+  proc->usado_cota += n;
+  if (proc->usado_cota >= proc->cota && !proc->estrangulado) {
+    esc_retira(self, proc);
+    proc->estrangulado = true;
+    self->n_estrangulados++;
+    proc->n_estrangulamentos++;
+  }
+}
+
+// no início de cada janela, renova as cotas; o que foi executado além da
+//   cota fica para a janela nova
+// só os processos da lista de cotas têm o que renovar; quem ficou sem cota e
+//   sem estrangulamento sai dela
+static void renova_cotas(escalonador_t *self)
+{
+  no_lista_t *prox;
+  for (no_lista_t *no = lista_primeiro(&self->cotas); no != NULL; no = prox) {
+    prox = lista_proximo(no);
+    processo_t *proc = LISTA_DONO(no, processo_t, no_cota);
+    proc->usado_cota = proc->usado_cota > proc->cota ? proc->usado_cota - proc->cota : 0;
+    if (proc->estrangulado && (proc->cota == 0 || proc->usado_cota < proc->cota)) {
+      proc->estrangulado = false;
+      self->n_estrangulados--;
+      if (proc->estado == pronto) esc_insere(self, proc);
+    }
+    if (proc->cota == 0 && !proc->estrangulado) lista_retira(&self->cotas, no);
+  }
+}
+
+
+// ---------------------------------------------------------------------
+// OPERAÇÕES {{{1
+// ---------------------------------------------------------------------
+
+bool esc_contem(escalonador_t *self, processo_t *proc)
+{
+  return fp_contem(&self->fila, proc) || proc->no_heap.no_heap
+         || proc->no_tempo_real.no_heap;
+}
+
+void esc_cria(escalonador_t *self, processo_t *proc)
+{
+  if (self->ops->cria != NULL) self->ops->cria(self, proc);
+}
+
+void esc_insere(escalonador_t *self, processo_t *proc)
+{
+  if (proc->estrangulado) return;
+  bool estava = esc_contem(self, proc);
+  if (!estava) proc->t_entrada_pronto = self->agora;
+  if (proc->tr.periodo > 0) {
+    if (!proc->tr.ativo && self->tiques >= proc->tr.liberacao) {
+      libera_job(self, proc);
+    }
+    if (proc->tr.ativo) {
+      heap_retira(&self->heap_tempo_real, &proc->no_tempo_real);
+      heap_insere(&self->heap_tempo_real, &proc->no_tempo_real, proc->tr.prazo);
+    } else {
+      // espera a liberação do próximo job (ver esc_tique)
+      heap_insere(&self->heap_liberacao, &proc->no_liberacao, proc->tr.liberacao);
+    }
+  } else {
+    self->ops->insere(self, proc);
+    if (self->ops->preemptiva) self->troca = true;
+  }
+  if (!estava && esc_contem(self, proc)) self->n_prontos++;
+}
+
+void esc_retira(escalonador_t *self, processo_t *proc)
+{
+  if (esc_contem(self, proc)) {
+    proc->t_executavel += self->agora - proc->t_entrada_pronto;
+    self->n_prontos--;
+  }
+  heap_retira(&self->heap_tempo_real, &proc->no_tempo_real);
+  heap_retira(&self->heap_liberacao, &proc->no_liberacao);
+  self->ops->retira(self, proc);
+}
+
+void esc_bloqueia(escalonador_t *self, processo_t *proc, motivo_bloqueio motivo)
+{
+  termina_job(self, proc);
+  if (proc->tr.periodo == 0 && self->ops->bloqueia != NULL) {
+    self->ops->bloqueia(self, proc, motivo);
+  }
+  esc_retira(self, proc);
+}
+
+void esc_desbloqueia(escalonador_t *self, processo_t *proc)
+{
+  if (proc->tr.periodo == 0 && self->ops->desbloqueia != NULL) {
+    self->ops->desbloqueia(self, proc);
+  }
+  esc_insere(self, proc);
+}
+
+void esc_morre(escalonador_t *self, processo_t *proc)
+{
+  termina_job(self, proc);
+  esc_retira(self, proc);
+  if (proc->tr.periodo > 0) self->n_tempo_real--;
+  if (proc->cota > 0) self->n_cotas--;
+  if (proc->estrangulado) self->n_estrangulados--;
+  lista_retira(&self->cotas, &proc->no_cota);
+}
+
+void esc_executou(escalonador_t *self, processo_t *proc, int n)
+{
+  consome_cota(self, proc, n);
+  if (proc->tr.periodo == 0 && self->ops->executou != NULL) {
+    self->ops->executou(self, proc, n);
+  }
+}
+
+void esc_tique(escalonador_t *self, processo_t *corrente)
+{
+  self->tiques++;
+  if (self->tiques % JANELA_COTA == 0) renova_cotas(self);
+  // desconta o orçamento do processo de tempo real corrente
+  if (corrente != NULL && corrente->estado == pronto && corrente->tr.ativo) {
+    corrente->tr.restante--;
+    if (corrente->tr.restante <= 0) {
+      termina_job(self, corrente);
+      esc_retira(self, corrente);
+      esc_insere(self, corrente);
+    }
+  }
+  // libera os jobs dos processos de tempo real cujo período começou; os que
+  //   esperam estão no heap de liberação, o primeiro é o mais próximo
+  no_heap_t *no;
+  while ((no = heap_menor(&self->heap_liberacao)) != NULL && no->chave <= self->tiques) {
+    heap_retira(&self->heap_liberacao, no);
+    esc_insere(self, HEAP_DONO(no, processo_t, no_liberacao));
+  }
+  if (self->ops->tique != NULL) {
+    if (corrente != NULL && (corrente->tr.periodo > 0 || corrente->estrangulado)) {
+      corrente = NULL;
+    }
+    self->ops->tique(self, corrente);
+  }
+}
+
+bool esc_deve_trocar(escalonador_t *self, processo_t *corrente)
+{
+  bool troca = self->troca;
+  self->troca = false;
+  if (corrente == NULL || corrente->estado != pronto || corrente->estrangulado) return true;
+  // os processos de tempo real preemptam os demais e entre si (pelo prazo),
+  //   e quem esgotou o orçamento sai da cpu até o próximo período
+  no_heap_t *tr = heap_menor(&self->heap_tempo_real);
+  if (tr != NULL && HEAP_DONO(tr, processo_t, no_tempo_real) != corrente) return true;
+  if (corrente->tr.periodo > 0 && !corrente->no_tempo_real.no_heap) return true;
+  return troca;
+}
+
+// o tique conta o quantum da política, quando há outro processo pronto além
+//   do corrente, e o tempo dos processos de tempo real e das cotas (mesmo que
+//   estejam bloqueados ou estrangulados)
+bool esc_precisa_tique(escalonador_t *self, processo_t *corrente)
+{
+  int outros = self->n_prontos;
+  if (corrente != NULL && esc_contem(self, corrente)) outros--;
+  if (outros > 0 && self->ops->tique != NULL) return true;
+  return self->n_tempo_real > 0 || self->n_cotas > 0 || self->n_estrangulados > 0;
+}
+
+processo_t *esc_proximo(escalonador_t *self)
+{
+  no_heap_t *tr = heap_menor(&self->heap_tempo_real);
+  if (tr != NULL) return HEAP_DONO(tr, processo_t, no_tempo_real);
+  return self->ops->proximo(self);
+}
+
+void esc_deixa_cpu(escalonador_t *self, processo_t *proc)
+{
+  if (proc->tr.periodo == 0 && self->ops->deixa_cpu != NULL) {
+    self->ops->deixa_cpu(self, proc);
+  }
+}
+
+void esc_escolhido(escalonador_t *self, processo_t *proc)
+{
+  if (proc->tr.periodo == 0 && self->ops->escolhido != NULL) {
+    self->ops->escolhido(self, proc);
+  }
+}
+
+
+// ---------------------------------------------------------------------
+// MÉTRICAS {{{1
+// ---------------------------------------------------------------------
+
+void esc_metricas(escalonador_t *self, Historicos *h)
+{
+  console_printf("Escalonador: %s", self->ops->nome);
+  // cumprimento dos prazos dos processos de tempo real
+  for (int i = 0; i < h->n; i++) {
+    Historico_processos *p = hst_busca(h, i);
+    if (p->tr.n_jobs == 0) continue;
+    console_printf("Processo %d (tempo real %d/%d): %d jobs, %d prazos perdidos, atraso maximo %d",
+                   p->id, p->tr.orcamento, p->tr.periodo, p->tr.n_jobs, p->tr.n_perdas,
+                   p->tr.atraso_max);
+    console_printf("  atrasos: 0:%d 1:%d 2-3:%d 4-7:%d 8+:%d", p->tr.atrasos[0],
+                   p->tr.atrasos[1], p->tr.atrasos[2], p->tr.atrasos[3], p->tr.atrasos[4]);
+  }
+  for (int i = 0; i < h->n; i++) {
+    Historico_processos *p = hst_busca(h, i);
+    if (p->cota == 0) continue;
+    console_printf("Processo %d (cota de %d instrucoes por janela): estrangulado %d vezes",
+                   p->id, p->cota, p->n_estrangulamentos);
+  }
+  if (self->ops->metricas != NULL) self->ops->metricas(self, h);
+}
+
+// vim: foldmethod=marker
@@ -0,0 +1,201 @@
+// escalonador.h
+// escalonador de processos, com políticas intercambiáveis
+// simulador de computador
+// so25b
+
+#ifndef ESCALONADOR_H
+#define ESCALONADOR_H
+
+// O escalonador mantém os processos prontos e escolhe qual deles executa.
+// A parte comum (escalonador.c) trata da classe de tempo real (ver
+//   SO_TEMPO_REAL em so.h), que tem preferência sobre os demais processos, e
+//   repassa o resto para a política corrente, que implementa as operações de
+//   esc_ops_t. Cada política fica em um arquivo esc_*.c e é registrada na
+//   tabela de escalonador.c; para criar uma política nova não é necessário
+//   alterar o SO.
+// A política pode ser trocada a qualquer momento; os processos prontos passam
+//   para as estruturas da nova política.
+//
+// O processo corrente continua entre os prontos enquanto executa.
+// O SO chama:
+// - esc_cria quando cria um processo, antes de colocá-lo entre os prontos
+// - esc_insere e esc_retira quando um processo fica ou deixa de ficar pronto
+// - esc_bloqueia e esc_desbloqueia quando um processo bloqueia ou desbloqueia,
+//   e esc_morre quando morre (esses chamam esc_retira e esc_insere)
+// - esc_executou a cada interrupção, com as instruções executadas pelo
+//   processo corrente desde a anterior
+// - esc_tique a cada interrupção do relógio
+// - esc_deve_trocar, esc_proximo, esc_deixa_cpu e esc_escolhido quando
+//   escalona
+// - esc_precisa_tique para saber se deve programar o relógio (o SO pode
+//   deixar de receber interrupções do relógio enquanto não precisar delas)
+
+#include "processo.h"
+#include "tabela_proc.h"
+#include "fila_prontos.h"
+#include "heap.h"
+#include "slab.h"
+#include "mapa.h"
+
+#include <stdbool.h>
+
+// nível da fila de prontos usado pelas políticas sem prioridade
+#define ESC_NIVEL_PADRAO (FP_N_NIVEIS / 2)
+
+// escalonador mlfq: número de níveis
+#define ESC_NIVEIS_MLFQ 4
+
+typedef struct escalonador_t escalonador_t;
+
+// escalonador grupos: um grupo de processos com processos prontos
+// só os grupos com processos prontos têm entrada; a entrada é liberada
+//   quando o último sai dos prontos
+typedef struct {
+  int id;                   // identificação do grupo
+  int n;                    // número de processos prontos do grupo
+  long long vruntime;       // tempo virtual do grupo (instruções dos seus processos)
+  long long vruntime_min;   // menor vruntime de processo do grupo já escalonado
+  heap_t prontos;           // os processos prontos do grupo, por vruntime
+  no_heap_t no_heap;        // encadeamento no heap de grupos
+} esc_grupo_t;
+
+// as operações de uma política; as que são NULL não fazem nada
+// 'insere', 'retira' e 'proximo' são obrigatórias
+typedef struct {
+  char *nome;
+  // se true, a chegada de um processo pronto faz reavaliar o corrente
+  bool preemptiva;
+  // cria: o processo foi criado (antes de ser inserido)
+  void (*cria)(escalonador_t *self, processo_t *proc);
+  // insere: coloca o processo entre os prontos
+  void (*insere)(escalonador_t *self, processo_t *proc);
+  // retira: tira o processo dos prontos
+  void (*retira)(escalonador_t *self, processo_t *proc);
+  // proximo: escolhe o processo a executar, sem retirar (NULL se não houver)
+  processo_t *(*proximo)(escalonador_t *self);
+  // escolhido: o processo passou a ser o corrente
+  void (*escolhido)(escalonador_t *self, processo_t *proc);
+  // deixa_cpu: o processo deixou de ser o corrente (bloqueou ou foi preemptado)
+  void (*deixa_cpu)(escalonador_t *self, processo_t *proc);
+  // executou: o processo corrente executou 'n' instruções
+  void (*executou)(escalonador_t *self, processo_t *proc, int n);
+  // tique: interrupção do relógio; 'corrente' é NULL se não há processo
+  //   corrente da política
+  void (*tique)(escalonador_t *self, processo_t *corrente);
+  // bloqueia, desbloqueia: o processo vai bloquear (antes de ser retirado),
+  //   esperando o que diz 'motivo', ou foi desbloqueado (antes de ser inserido)
+  void (*bloqueia)(escalonador_t *self, processo_t *proc, motivo_bloqueio motivo);
+  void (*desbloqueia)(escalonador_t *self, processo_t *proc);
+  // metricas: imprime as métricas da política no fim da execução
+  void (*metricas)(escalonador_t *self, Historicos *h);
+} esc_ops_t;
+
+// o estado do escalonador fica nesta estrutura, nos descritores dos
+//   processos e nas entradas dos grupos (ver esc_salva)
+struct escalonador_t {
+  const esc_ops_t *ops;
+  tabela_proc_t *tabela;    // a tabela de processos
+  int agora;                // relógio (em instruções) da interrupção atual
+  int tiques;               // número de interrupções do relógio
+  int n_prontos;            // processos nas estruturas de prontos
+  // processos vivos que precisam do tique mesmo sem outro pronto
+  int n_tempo_real;         //   na classe de tempo real
+  int n_cotas;              //   com cota de cpu
+  int n_estrangulados;      //   estrangulados (esgotaram a cota)
+  bool troca;               // o processo corrente deve ser reavaliado
+  heap_t heap_tempo_real;   // processos de tempo real com job liberado, por prazo
+  heap_t heap_liberacao;    // os prontos esperando o próximo job, por liberação
+  lista_t cotas;            // processos com cota ou estrangulados
+  // estruturas de prontos à disposição das políticas
+  fila_prontos_t fila;
+  heap_t heap;
+  // estado das políticas
+  long long vruntime_min;   // justo: menor vruntime já escalonado (só cresce)
+  long long passada_min;    // passada: idem, passada
+  unsigned semente;         // loteria: estado do gerador de números aleatórios
+  int mlfq_ocupacao[ESC_NIVEIS_MLFQ];  // mlfq: soma dos prontos em cada nível, a cada tique
+  int mlfq_tiques;
+  int mlfq_rebaixamentos;
+  int mlfq_promocoes;
+  int mlfq_envelhecimentos;
+  slab_t *grupos;           // grupos: as entradas dos grupos (esc_grupo_t)
+  mapa_t *mapa_grupos;      //   a entrada de cada grupo, pelo id
+  heap_t heap_grupos;       //   os grupos, por vruntime
+};
+
+// inicializa o escalonador, com a política de nome 'nome' (se não existir,
+//   usa a primeira da tabela)
+void esc_inicializa(escalonador_t *self, tabela_proc_t *tabela, char *nome);
+
+// libera a memória alocada pelo escalonador
+void esc_finaliza(escalonador_t *self);
+
+// funções para salvar e recuperar o estado que não está na estrutura nem
+//   nos descritores (as entradas dos grupos) em um instantâneo; o estado é
+//   salvo em 'estado', que deve ter esc_tam_estado() bytes
+// esc_restaura retorna false, sem alterar o escalonador, se faltar memória
+int esc_tam_estado(escalonador_t *self);
+void esc_salva(escalonador_t *self, void *estado);
+bool esc_restaura(escalonador_t *self, void *estado);
+
+// retorna a política com o nome dado, ou NULL
+const esc_ops_t *esc_busca(char *nome);
+
+// imprime na console os nomes das políticas disponíveis
+void esc_lista(void);
+
+// troca a política corrente, passando os processos prontos para ela
+void esc_muda_politica(escalonador_t *self, const esc_ops_t *ops);
+
+// nome da política corrente
+char *esc_nome(escalonador_t *self);
+
+// define o relógio (em instruções) da interrupção sendo atendida
+void esc_define_agora(escalonador_t *self, int agora);
+
+// operações chamadas pelo SO (ver acima)
+void esc_cria(escalonador_t *self, processo_t *proc);
+void esc_insere(escalonador_t *self, processo_t *proc);
+void esc_retira(escalonador_t *self, processo_t *proc);
+void esc_bloqueia(escalonador_t *self, processo_t *proc, motivo_bloqueio motivo);
+void esc_desbloqueia(escalonador_t *self, processo_t *proc);
+void esc_morre(escalonador_t *self, processo_t *proc);
+void esc_executou(escalonador_t *self, processo_t *proc, int n);
+void esc_tique(escalonador_t *self, processo_t *corrente);
+bool esc_deve_trocar(escalonador_t *self, processo_t *corrente);
+bool esc_precisa_tique(escalonador_t *self, processo_t *corrente);
+processo_t *esc_proximo(escalonador_t *self);
+void esc_deixa_cpu(escalonador_t *self, processo_t *proc);
+void esc_escolhido(escalonador_t *self, processo_t *proc);
+
+// define a cota de cpu do processo, em instruções por janela (ver SO_COTA)
+// retorna false se a cota for inválida
+bool esc_cota(escalonador_t *self, processo_t *proc, int cota);
+
+// retorna true se o processo está entre os prontos
+bool esc_contem(escalonador_t *self, processo_t *proc);
+
+// põe o processo na classe de tempo real com o período e orçamento dados, ou
+//   tira dela se o período for 0 (ver SO_TEMPO_REAL)
+// retorna false se os valores forem inválidos ou o processo não for admitido
+bool esc_tempo_real(escalonador_t *self, processo_t *proc, int periodo, int orcamento);
+
+// imprime as métricas da classe de tempo real e da política
+void esc_metricas(escalonador_t *self, Historicos *h);
+
+// métricas das políticas com bilhetes (em esc_loteria.c)
+void esc_metricas_bilhetes(escalonador_t *self, Historicos *h);
+
+// as políticas disponíveis (ver os arquivos esc_*.c)
+extern const esc_ops_t esc_simples;
+extern const esc_ops_t esc_round_robin;
+extern const esc_ops_t esc_prioridade;
+extern const esc_ops_t esc_justo;
+extern const esc_ops_t esc_mlfq;
+extern const esc_ops_t esc_loteria;
+extern const esc_ops_t esc_passada;
+extern const esc_ops_t esc_sjf;
+extern const esc_ops_t esc_srtf;
+extern const esc_ops_t esc_grupos;
+
+#endif // ESCALONADOR_H
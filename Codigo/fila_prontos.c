@@ -0,0 +1,86 @@
+// fila_prontos.c
+// fila de processos prontos, com um nível por prioridade
+// simulador de computador
+// so25b
+
+#include "fila_prontos.h"
+
+#include <stddef.h>
+
+void fp_inicializa(fila_prontos_t *self)
+{
+  self->mapa = 0;
+  for (int i = 0; i < FP_N_NIVEIS; i++) {
+    self->ini[i] = NULL;
+    self->fim[i] = NULL;
+    self->n_nivel[i] = 0;
+  }
+  self->n = 0;
+}
+
+void fp_insere(fila_prontos_t *self, processo_t *proc, int nivel)
+{
+  if (proc->fp_nivel != FP_FORA) return;
+  if (nivel < 0) nivel = 0;
+  if (nivel >= FP_N_NIVEIS) nivel = FP_N_NIVEIS - 1;
+
+  proc->fp_nivel = nivel;
+  proc->fp_prox = NULL;
+  proc->fp_ant = self->fim[nivel];
+  if (self->fim[nivel] == NULL) {
+    self->ini[nivel] = proc;
+    self->mapa |= 1u << nivel;
+  } else {
+    self->fim[nivel]->fp_prox = proc;
+  }
+  self->fim[nivel] = proc;
+  self->n_nivel[nivel]++;
+  self->n++;
+}
+
+void fp_retira(fila_prontos_t *self, processo_t *proc)
+{
+  int nivel = proc->fp_nivel;
+  if (nivel == FP_FORA) return;
+
+  if (proc->fp_ant == NULL) {
+    self->ini[nivel] = proc->fp_prox;
+  } else {
+    proc->fp_ant->fp_prox = proc->fp_prox;
+  }
+  if (proc->fp_prox == NULL) {
+    self->fim[nivel] = proc->fp_ant;
+  } else {
+    proc->fp_prox->fp_ant = proc->fp_ant;
+  }
+  if (self->ini[nivel] == NULL) {
+    self->mapa &= ~(1u << nivel);
+  }
+  proc->fp_nivel = FP_FORA;
+  proc->fp_prox = proc->fp_ant = NULL;
+  self->n_nivel[nivel]--;
+  self->n--;
+}
+
+processo_t *fp_primeiro(fila_prontos_t *self)
+{
+  if (self->mapa == 0) return NULL;
+  // o bit menos significativo ligado é o nível não vazio de maior prioridade
+  return self->ini[__builtin_ctz(self->mapa)];
+}
+
+bool fp_contem(fila_prontos_t *self, processo_t *proc)
+{
+  return proc->fp_nivel != FP_FORA;
+}
+
+int fp_n(fila_prontos_t *self)
+{
+  return self->n;
+}
+
+int fp_n_nivel(fila_prontos_t *self, int nivel)
+{
+  if (nivel < 0 || nivel >= FP_N_NIVEIS) return 0;
+  return self->n_nivel[nivel];
+}
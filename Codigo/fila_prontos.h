@@ -0,0 +1,54 @@
+// fila_prontos.h
+// fila de processos prontos, com um nível por prioridade
+// simulador de computador
+// so25b
+
+#ifndef FILA_PRONTOS_H
+#define FILA_PRONTOS_H
+
+// A fila tem FP_N_NIVEIS níveis, cada um uma fila FIFO de processos; o nível
+//   0 é o de maior prioridade. Um mapa de bits indica quais níveis não estão
+//   vazios, e o primeiro processo da fila é o primeiro do menor nível não
+//   vazio.
+// Os encadeamentos ficam no próprio descritor do processo (campos fp_*),
+//   então as operações não alocam memória, e todas são O(1).
+// Um processo só pode estar na fila uma vez.
+
+#include "processo.h"
+
+#include <stdbool.h>
+
+// número de níveis de prioridade (no máximo o número de bits de um unsigned)
+#define FP_N_NIVEIS 32
+
+typedef struct {
+  unsigned int mapa;   // bit n ligado se o nível n não está vazio
+  processo_t *ini[FP_N_NIVEIS];
+  processo_t *fim[FP_N_NIVEIS];
+  int n_nivel[FP_N_NIVEIS];  // número de processos em cada nível
+  int n;               // número de processos na fila
+} fila_prontos_t;
+
+// inicializa uma fila vazia
+void fp_inicializa(fila_prontos_t *self);
+
+// insere o processo no final do nível 'nivel' (limitado a [0, FP_N_NIVEIS))
+// se o processo já estiver na fila, não faz nada
+void fp_insere(fila_prontos_t *self, processo_t *proc, int nivel);
+
+// retira o processo da fila (se não estiver, não faz nada)
+void fp_retira(fila_prontos_t *self, processo_t *proc);
+
+// retorna o primeiro processo da fila (sem retirar), ou NULL se vazia
+processo_t *fp_primeiro(fila_prontos_t *self);
+
+// retorna true se o processo está na fila
+bool fp_contem(fila_prontos_t *self, processo_t *proc);
+
+// retorna o número de processos na fila
+int fp_n(fila_prontos_t *self);
+
+// retorna o número de processos no nível 'nivel' da fila
+int fp_n_nivel(fila_prontos_t *self, int nivel);
+
+#endif // FILA_PRONTOS_H
@@ -0,0 +1,118 @@
+// heap.c
+// heap de emparelhamento (pairing heap) intrusivo, ordenado por uma chave
+// simulador de computador
+// so25b
+
+#include "heap.h"
+
+void heap_inicializa(heap_t *self)
+{
+  self->raiz = NULL;
+  self->n = 0;
+  self->n_insercoes = 0;
+}
+
+void heap_inicializa_no(no_heap_t *no)
+{
+  no->chave = 0;
+  no->ordem = 0;
+  no->no_heap = false;
+  no->filho = no->irmao = no->ant = NULL;
+}
+
+// true se 'a' deve sair do heap antes de 'b'
+static bool antes(no_heap_t *a, no_heap_t *b)
+{
+  if (a->chave != b->chave) return a->chave < b->chave;
+  return a->ordem < b->ordem;
+}
+
+// junta duas árvores (raízes sem irmãos), retorna a raiz da resultante
+static no_heap_t *junta(no_heap_t *a, no_heap_t *b)
+{
+  if (a == NULL) return b;
+  if (b == NULL) return a;
+  if (antes(b, a)) {
+    no_heap_t *t = a;
+    a = b;
+    b = t;
+  }
+  // b vira o primeiro filho de a
+  b->irmao = a->filho;
+  if (a->filho != NULL) a->filho->ant = b;
+  b->ant = a;
+  a->filho = b;
+  a->irmao = NULL;
+  a->ant = NULL;
+  return a;
+}
+
+// junta uma lista de irmãos em uma só árvore (em duas passadas: junta aos
+//   pares da esquerda para a direita, depois da direita para a esquerda)
+static no_heap_t *junta_irmaos(no_heap_t *primeiro)
+{
+  if (primeiro == NULL) return NULL;
+  // primeira passada, os pares são encadeados ao contrário pelo campo 'ant'
+  no_heap_t *pares = NULL;
+  while (primeiro != NULL) {
+    no_heap_t *a = primeiro;
+    no_heap_t *b = a->irmao;
+    primeiro = b == NULL ? NULL : b->irmao;
+    a->irmao = a->ant = NULL;
+    if (b != NULL) b->irmao = b->ant = NULL;
+    no_heap_t *j = junta(a, b);
+    j->ant = pares;
+    pares = j;
+  }
+  // segunda passada
+  no_heap_t *raiz = NULL;
+  while (pares != NULL) {
+    no_heap_t *prox = pares->ant;
+    pares->ant = NULL;
+    raiz = junta(raiz, pares);
+    pares = prox;
+  }
+  return raiz;
+}
+
+void heap_insere(heap_t *self, no_heap_t *no, long long chave)
+{
+  if (no->no_heap) return;
+  no->chave = chave;
+  no->ordem = self->n_insercoes++;
+  no->no_heap = true;
+  no->filho = no->irmao = no->ant = NULL;
+  self->raiz = junta(self->raiz, no);
+  self->n++;
+}
+
+void heap_retira(heap_t *self, no_heap_t *no)
+{
+  if (!no->no_heap) return;
+  if (no == self->raiz) {
+    self->raiz = junta_irmaos(no->filho);
+  } else {
+    // desliga a subárvore do nó, junta os filhos e junta o resultado à raiz
+    if (no->ant->filho == no) {
+      no->ant->filho = no->irmao;
+    } else {
+      no->ant->irmao = no->irmao;
+    }
+    if (no->irmao != NULL) no->irmao->ant = no->ant;
+    no->irmao = no->ant = NULL;
+    self->raiz = junta(self->raiz, junta_irmaos(no->filho));
+  }
+  if (self->raiz != NULL) self->raiz->ant = NULL;
+  heap_inicializa_no(no);
+  self->n--;
+}
+
+no_heap_t *heap_menor(heap_t *self)
+{
+  return self->raiz;
+}
+
+int heap_n(heap_t *self)
+{
+  return self->n;
+}
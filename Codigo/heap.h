@@ -0,0 +1,59 @@
+// heap.h
+// heap de emparelhamento (pairing heap) intrusivo, ordenado por uma chave
+// simulador de computador
+// so25b
+
+#ifndef HEAP_H
+#define HEAP_H
+
+// Os nós ficam dentro das estruturas que são colocadas no heap (por
+//   exemplo, no descritor do processo); as operações não alocam memória.
+// O nó de menor chave fica na raiz; em caso de empate, o que foi inserido
+//   antes sai antes.
+// Inserção e consulta ao menor são O(1); a retirada é O(log n) amortizado.
+// Para alterar a chave de um nó, retira-se o nó, altera-se a chave e
+//   insere-se o nó novamente.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct no_heap_t no_heap_t;
+struct no_heap_t {
+  long long chave;   // long long para os tempos virtuais, que só crescem
+  long ordem;        // ordem de inserção, para desempate
+  bool no_heap;      // true se o nó está em algum heap
+  no_heap_t *filho;  // primeiro filho
+  no_heap_t *irmao;  // próximo irmão
+  no_heap_t *ant;    // irmão anterior, ou pai se for o primeiro filho
+};
+
+typedef struct {
+  no_heap_t *raiz;
+  int n;             // número de nós no heap
+  long n_insercoes;
+} heap_t;
+
+// obtém o ponteiro para a estrutura que contém o nó 'no', que está no
+//   campo 'campo' de uma estrutura do tipo 'tipo'
+#define HEAP_DONO(no, tipo, campo) ((tipo *)((char *)(no) - offsetof(tipo, campo)))
+
+// inicializa um heap vazio
+void heap_inicializa(heap_t *self);
+
+// inicializa um nó, que fica fora de qualquer heap
+void heap_inicializa_no(no_heap_t *no);
+
+// insere no heap o nó 'no', com a chave 'chave'
+// se o nó já estiver no heap, não faz nada
+void heap_insere(heap_t *self, no_heap_t *no, long long chave);
+
+// retira o nó do heap (se não estiver, não faz nada)
+void heap_retira(heap_t *self, no_heap_t *no);
+
+// retorna o nó de menor chave (sem retirar), ou NULL se o heap estiver vazio
+no_heap_t *heap_menor(heap_t *self);
+
+// retorna o número de nós no heap
+int heap_n(heap_t *self);
+
+#endif // HEAP_H
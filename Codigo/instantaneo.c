@@ -0,0 +1,212 @@
+// instantaneo.c
+// instantâneos do estado do computador, para voltar no tempo
+// simulador de computador
+// so25b
+
+#include "instantaneo.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+// número máximo de instantâneos mantidos
+#define INST_MAX 64
+// a cada quantos instantâneos é feito um completo (INST_MAX deve ser múltiplo)
+#define INST_CHAVE 16
+// número máximo de componentes registrados
+#define INST_MAX_COMPONENTES 16
+
+// um componente com estado a salvar
+typedef struct {
+  void *componente;
+  f_salva_t f_salva;
+  f_restaura_t f_restaura;
+} componente_t;
+
+// um instantâneo
+typedef struct {
+  int tempo;
+  // se true, contém todas as páginas da memória
+  bool completo;
+  // as páginas copiadas (as sujas desde o instantâneo anterior) e seu conteúdo,
+  //   MEM_TAM_PAGINA valores para cada página
+  int n_paginas;
+  int *paginas;
+  int *dados;
+  // estado de cada componente
+  void *estados[INST_MAX_COMPONENTES];
+} foto_t;
+
+struct instantaneo_t {
+  mem_t *mem;
+  int n_componentes;
+  componente_t componentes[INST_MAX_COMPONENTES];
+  // os instantâneos, em ordem de tempo
+  int n_fotos;
+  foto_t *fotos[INST_MAX];
+  // auxiliar para a recuperação da memória, uma entrada por página
+  bool *recuperada;
+};
+
+instantaneo_t *instantaneo_cria(mem_t *mem)
+{
+  instantaneo_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+
+  self->mem = mem;
+  self->n_componentes = 0;
+  self->n_fotos = 0;
+  self->recuperada = malloc(mem_n_paginas(mem) * sizeof(*(self->recuperada)));
+  assert(self->recuperada != NULL);
+
+  return self;
+}
+
+static void foto_destroi(foto_t *foto)
+{
+  for (int c = 0; c < INST_MAX_COMPONENTES; c++) {
+    free(foto->estados[c]);
+  }
+  free(foto->paginas);
+  free(foto->dados);
+  free(foto);
+}
+
+// descarta os instantâneos em [ini, fim), mantendo a ordem dos demais
+static void descarta_fotos(instantaneo_t *self, int ini, int fim)
+{
+  for (int i = ini; i < fim; i++) {
+    foto_destroi(self->fotos[i]);
+  }
+  memmove(&self->fotos[ini], &self->fotos[fim],
+          (self->n_fotos - fim) * sizeof(self->fotos[0]));
+  self->n_fotos -= fim - ini;
+}
+
+void instantaneo_destroi(instantaneo_t *self)
+{
+  descarta_fotos(self, 0, self->n_fotos);
+  free(self->recuperada);
+  free(self);
+}
+
+bool instantaneo_registra(instantaneo_t *self, void *componente,
+                          f_salva_t f_salva, f_restaura_t f_restaura)
+{
+  if (self->n_componentes >= INST_MAX_COMPONENTES) return false;
+  componente_t *c = &self->componentes[self->n_componentes++];
+  c->componente = componente;
+  c->f_salva = f_salva;
+  c->f_restaura = f_restaura;
+  return true;
+}
+
+int instantaneo_quantos(instantaneo_t *self)
+{
+  return self->n_fotos;
+}
+
+// número de valores da página (a última pode ser menor)
+static int tam_pagina(instantaneo_t *self, int pagina)
+{
+  int resto = mem_tam(self->mem) - pagina * MEM_TAM_PAGINA;
+  return resto < MEM_TAM_PAGINA ? resto : MEM_TAM_PAGINA;
+}
+
+// número de instantâneos desde o último completo
+static int desde_completo(instantaneo_t *self)
+{
+  int n = 0;
+  for (int i = self->n_fotos - 1; i >= 0 && !self->fotos[i]->completo; i--) {
+    n++;
+  }
+  return n;
+}
+
+void instantaneo_tira(instantaneo_t *self, int tempo)
+{
+  // se não tem mais lugar, descarta os mais antigos até o segundo completo
+  if (self->n_fotos >= INST_MAX) {
+    int i = 1;
+    while (i < self->n_fotos && !self->fotos[i]->completo) i++;
+    descarta_fotos(self, 0, i);
+  }
+
+  foto_t *foto = calloc(1, sizeof(*foto));
+  assert(foto != NULL);
+  foto->tempo = tempo;
+  foto->completo = self->n_fotos == 0 || desde_completo(self) >= INST_CHAVE - 1;
+
+  // conta e copia as páginas
+  int n_pag = mem_n_paginas(self->mem);
+  if (foto->completo) {
+    foto->n_paginas = n_pag;
+  } else {
+    for (int p = mem_proxima_pagina_suja(self->mem, 0); p != -1;
+         p = mem_proxima_pagina_suja(self->mem, p + 1)) {
+      foto->n_paginas++;
+    }
+  }
+  foto->paginas = malloc((foto->n_paginas + 1) * sizeof(*(foto->paginas)));
+  foto->dados = malloc((foto->n_paginas * MEM_TAM_PAGINA + 1) * sizeof(*(foto->dados)));
+  assert(foto->paginas != NULL && foto->dados != NULL);
+  int p = foto->completo ? 0 : mem_proxima_pagina_suja(self->mem, 0);
+  for (int i = 0; i < foto->n_paginas; i++) {
+    foto->paginas[i] = p;
+    mem_le_bloco(self->mem, p * MEM_TAM_PAGINA, &foto->dados[i * MEM_TAM_PAGINA],
+                 tam_pagina(self, p));
+    p = foto->completo ? p + 1 : mem_proxima_pagina_suja(self->mem, p + 1);
+  }
+  mem_limpa_paginas_sujas(self->mem);
+
+  // salva o estado dos componentes
+  for (int c = 0; c < self->n_componentes; c++) {
+    componente_t *comp = &self->componentes[c];
+    foto->estados[c] = comp->f_salva(comp->componente);
+  }
+
+  self->fotos[self->n_fotos++] = foto;
+}
+
+int instantaneo_volta(instantaneo_t *self, int tempo)
+{
+  // encontra o último instantâneo antes de 'tempo'
+  int k = self->n_fotos - 1;
+  while (k >= 0 && self->fotos[k]->tempo >= tempo) k--;
+  if (k < 0) return -1;
+
+  // recupera o estado dos componentes, antes da memória para poder desistir
+  foto_t *alvo = self->fotos[k];
+  for (int c = self->n_componentes - 1; c >= 0; c--) {
+    componente_t *comp = &self->componentes[c];
+    if (alvo->estados[c] != NULL
+        && !comp->f_restaura(comp->componente, alvo->estados[c])) {
+      return -2;
+    }
+  }
+
+  // recupera cada página da memória do instantâneo mais recente que a contém,
+  //   voltando até um completo
+  int n_pag = mem_n_paginas(self->mem);
+  memset(self->recuperada, false, n_pag * sizeof(*(self->recuperada)));
+  for (int i = k; i >= 0; i--) {
+    foto_t *foto = self->fotos[i];
+    for (int j = 0; j < foto->n_paginas; j++) {
+      int p = foto->paginas[j];
+      if (self->recuperada[p]) continue;
+      // a recuperação altera até as páginas protegidas
+      int so_leitura = mem_atributos(self->mem, p) & MEM_PAG_SO_LEITURA;
+      mem_desliga_atributos(self->mem, p, 1, so_leitura);
+      mem_copia(self->mem, p * MEM_TAM_PAGINA, &foto->dados[j * MEM_TAM_PAGINA],
+                tam_pagina(self, p));
+      mem_liga_atributos(self->mem, p, 1, so_leitura);
+      self->recuperada[p] = true;
+    }
+    if (foto->completo) break;
+  }
+  // a memória está igual ao instantâneo, nada mudou desde ele
+  mem_limpa_paginas_sujas(self->mem);
+
+  descarta_fotos(self, k + 1, self->n_fotos);
+  return alvo->tempo;
+}
@@ -0,0 +1,64 @@
+// instantaneo.h
+// instantâneos do estado do computador, para voltar no tempo
+// simulador de computador
+// so25b
+
+#ifndef INSTANTANEO_H
+#define INSTANTANEO_H
+
+// Mantém uma sequência de instantâneos (cópias do estado) do computador
+//   simulado, e permite voltar a simulação para qualquer um deles.
+// Um instantâneo contém o conteúdo da memória e o estado de cada componente
+//   registrado (CPU, relógio, terminais, SO...).
+// Os instantâneos são incrementais: só são copiadas as páginas da memória
+//   que foram alteradas desde o instantâneo anterior (ver páginas sujas em
+//   memoria.h). De tempos em tempos é feito um instantâneo completo, e para
+//   recuperar a memória de um instantâneo volta-se no máximo até o último
+//   instantâneo completo anterior a ele.
+// Quando o número máximo de instantâneos é atingido, os mais antigos são
+//   descartados.
+
+#include "memoria.h"
+
+#include <stdbool.h>
+
+typedef struct instantaneo_t instantaneo_t;
+
+// tipos das funções que um componente deve implementar para ter seu estado
+//   salvo nos instantâneos
+// a função de salvamento retorna uma cópia do estado do componente, em
+//   memória alocada com malloc (e que será liberada com free)
+// a função de restauração altera o estado do componente para o que foi
+//   salvo (sem liberar a cópia, que pode ser usada de novo); retorna false,
+//   sem alterar o componente, se não conseguir
+// os componentes são recuperados do último registrado para o primeiro, e a
+//   volta desiste no primeiro que falhar; um componente cuja recuperação pode
+//   falhar deve ser registrado por último
+typedef void *(*f_salva_t)(void *componente);
+typedef bool (*f_restaura_t)(void *componente, void *estado);
+
+// cria um gerenciador de instantâneos para o computador com a memória 'mem'
+instantaneo_t *instantaneo_cria(mem_t *mem);
+
+// destrói o gerenciador e todos os instantâneos
+void instantaneo_destroi(instantaneo_t *self);
+
+// registra um componente cujo estado deve ser salvo nos instantâneos
+// retorna false se não foi possível registrar
+bool instantaneo_registra(instantaneo_t *self, void *componente,
+                          f_salva_t f_salva, f_restaura_t f_restaura);
+
+// tira um instantâneo do estado atual; 'tempo' identifica o momento
+//   (número de instruções executadas)
+void instantaneo_tira(instantaneo_t *self, int tempo);
+
+// volta o estado do computador para o último instantâneo anterior a
+//   'tempo'; os instantâneos posteriores a ele são descartados
+// retorna o tempo do instantâneo recuperado, -1 se não houver, ou -2 se a
+//   recuperação de um componente falhar (e o computador fica como estava)
+int instantaneo_volta(instantaneo_t *self, int tempo);
+
+// retorna o número de instantâneos disponíveis
+int instantaneo_quantos(instantaneo_t *self);
+
+#endif // INSTANTANEO_H
@@ -15,9 +15,8 @@ typedef enum {
   IRQ_SISTEMA,       // chamada de sistema
   // interrupções geradas por dispositivos de E/S
   IRQ_RELOGIO,       // interrupção causada pelo relógio
-  // interrupções de E/S ainda não implementadas
-  IRQ_TECLADO,       // interrupção causada pelo teclado
-  IRQ_TELA,          // interrupção causada pela tela
+  IRQ_TECLADO,       // chegou um caractere em algum teclado
+  IRQ_TELA,          // alguma tela voltou a aceitar caracteres
   N_IRQ              // número de interrupções
 } irq_t;
 
@@ -0,0 +1,66 @@
+// lista.c
+// lista duplamente encadeada intrusiva
+// simulador de computador
+// so25b
+
+#include "lista.h"
+
+void lista_inicializa(lista_t *self)
+{
+  self->ini = NULL;
+  self->fim = NULL;
+  self->n = 0;
+}
+
+void lista_inicializa_no(no_lista_t *no)
+{
+  no->prox = no->ant = NULL;
+  no->na_lista = false;
+}
+
+void lista_insere(lista_t *self, no_lista_t *no)
+{
+  if (no->na_lista) return;
+  no->na_lista = true;
+  no->prox = NULL;
+  no->ant = self->fim;
+  if (self->fim == NULL) {
+    self->ini = no;
+  } else {
+    self->fim->prox = no;
+  }
+  self->fim = no;
+  self->n++;
+}
+
+void lista_retira(lista_t *self, no_lista_t *no)
+{
+  if (!no->na_lista) return;
+  if (no->ant == NULL) {
+    self->ini = no->prox;
+  } else {
+    no->ant->prox = no->prox;
+  }
+  if (no->prox == NULL) {
+    self->fim = no->ant;
+  } else {
+    no->prox->ant = no->ant;
+  }
+  lista_inicializa_no(no);
+  self->n--;
+}
+
+no_lista_t *lista_primeiro(lista_t *self)
+{
+  return self->ini;
+}
+
+no_lista_t *lista_proximo(no_lista_t *no)
+{
+  return no->prox;
+}
+
+int lista_n(lista_t *self)
+{
+  return self->n;
+}
@@ -0,0 +1,60 @@
+// lista.h
+// lista duplamente encadeada intrusiva
+// simulador de computador
+// so25b
+
+#ifndef LISTA_H
+#define LISTA_H
+
+// Os nós ficam dentro das estruturas que são colocadas na lista (por
+//   exemplo, no descritor do processo); as operações não alocam memória, e
+//   inserir e retirar são O(1).
+// Uma estrutura pode estar em várias listas ao mesmo tempo, com um nó para
+//   cada uma, mas cada nó só pode estar em uma lista.
+// A lista não aponta para si mesma, então pode ser copiada (num instantâneo,
+//   por exemplo) sem ajuste.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct no_lista_t no_lista_t;
+struct no_lista_t {
+  no_lista_t *prox;
+  no_lista_t *ant;
+  bool na_lista;     // true se o nó está em alguma lista
+};
+
+typedef struct {
+  no_lista_t *ini;
+  no_lista_t *fim;
+  int n;             // número de nós na lista
+} lista_t;
+
+// obtém o ponteiro para a estrutura que contém o nó 'no', que está no
+//   campo 'campo' de uma estrutura do tipo 'tipo'
+#define LISTA_DONO(no, tipo, campo) ((tipo *)((char *)(no) - offsetof(tipo, campo)))
+
+// inicializa uma lista vazia
+void lista_inicializa(lista_t *self);
+
+// inicializa um nó, que fica fora de qualquer lista
+void lista_inicializa_no(no_lista_t *no);
+
+// insere o nó no final da lista
+// se o nó já estiver em uma lista, não faz nada
+void lista_insere(lista_t *self, no_lista_t *no);
+
+// retira o nó da lista (se não estiver, não faz nada)
+void lista_retira(lista_t *self, no_lista_t *no);
+
+// retorna o primeiro nó da lista, ou NULL se ela estiver vazia
+no_lista_t *lista_primeiro(lista_t *self);
+
+// retorna o nó seguinte a 'no', ou NULL se ele for o último
+// para retirar nós durante um percurso, pegue o seguinte antes de retirar
+no_lista_t *lista_proximo(no_lista_t *no);
+
+// retorna o número de nós na lista
+int lista_n(lista_t *self);
+
+#endif // LISTA_H
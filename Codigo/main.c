@@ -8,14 +8,18 @@
 #include "memoria.h"
 #include "cpu.h"
 #include "relogio.h"
+#include "pic.h"
 #include "console.h"
 #include "terminal.h"
 #include "es.h"
 #include "dispositivos.h"
 #include "so.h"
+#include "rastro.h"
+#include "instantaneo.h"
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 // constantes
 #define MEM_TAM 10000        // tamanho da memória principal
@@ -25,11 +29,19 @@ typedef struct {
   mem_t *mem;
   cpu_t *cpu;
   relogio_t *relogio;
+  pic_t *pic;
   console_t *console;
   es_t *es;
   controle_t *controle;
+  rastro_t *rastro;
+  instantaneo_t *inst;
 } hardware_t;
 
+// nome do arquivo para o rastro de acessos à memória (NULL se não for rastrear)
+static char *nome_rastro = NULL;
+// nome do escalonador de processos (NULL para usar o padrão do SO)
+static char *nome_escalonador = NULL;
+
 
 // registra no controlador de es os 4 dispositivos do terminal 'id_term'
 //   da console, com valores a partir de n_disp
@@ -69,11 +81,9 @@ static void inicializa_rom(mem_t *mem)
     exit(1);
   }
 
-  for (int end = end_ini; end < end_fim; end++) {
-    if (mem_escreve(mem, end, prog_dado(prog, end)) != ERR_OK) {
-      printf("Erro na carga da memória ROM, endereco %d\n", end);
-      exit(1);
-    }
+  if (prog_carrega(prog, mem) != ERR_OK) {
+    printf("Erro na carga da memória ROM, endereços %d-%d\n", end_ini, end_fim);
+    exit(1);
   }
   prog_destroi(prog);
 }
@@ -87,6 +97,7 @@ static void cria_hardware(hardware_t *hw)
   // cria dispositivos de E/S
   hw->console = console_cria();
   hw->relogio = relogio_cria();
+  hw->pic = pic_cria();
 
   // cria o controlador de E/S e registra os dispositivos
   //   por exemplo, o dispositivo 8 do controlador de E/S (e da CPU) será o
@@ -102,34 +113,99 @@ static void cria_hardware(hardware_t *hw)
   es_registra_dispositivo(hw->es, D_RELOGIO_REAL      , hw->relogio, 1, relogio_leitura, NULL);
   es_registra_dispositivo(hw->es, D_RELOGIO_TIMER     , hw->relogio, 2, relogio_leitura, relogio_escrita);
   es_registra_dispositivo(hw->es, D_RELOGIO_INTERRUPCAO,hw->relogio, 3, relogio_leitura, relogio_escrita);
+  // registra os dispositivos do PIC
+  for (int id = 0; id < PIC_N_DISP; id++) {
+    es_registra_dispositivo(hw->es, D_PIC + id, hw->pic, id, pic_leitura, pic_escrita);
+  }
 
   // cria a unidade de execução e inicializa com a memória e o controlador de E/S
   hw->cpu = cpu_cria(hw->mem, hw->es);
 
-  // cria o controlador da CPU e inicializa com a unidade de execução, a console e
-  //   o relógio
-  hw->controle = controle_cria(hw->cpu, hw->console, hw->relogio);
+  // cria o rastro de acessos à memória, se foi pedido
+  hw->rastro = NULL;
+  if (nome_rastro != NULL) {
+    hw->rastro = rastro_cria(nome_rastro);
+    if (hw->rastro == NULL) {
+      fprintf(stderr, "Erro na criação do rastro '%s'\n", nome_rastro);
+      exit(1);
+    }
+    cpu_define_rastro(hw->cpu, hw->rastro);
+  }
+
+  // cria o controlador da CPU e inicializa com a unidade de execução, a console,
+  //   o relógio e o PIC
+  hw->controle = controle_cria(hw->cpu, hw->console, hw->relogio, hw->pic);
+
+  // cria o gerenciador de instantâneos e registra os componentes com estado
+  //   (o SO é registrado depois de criado)
+  hw->inst = instantaneo_cria(hw->mem);
+  instantaneo_registra(hw->inst, hw->cpu, cpu_salva, cpu_restaura);
+  instantaneo_registra(hw->inst, hw->relogio, relogio_salva, relogio_restaura);
+  instantaneo_registra(hw->inst, hw->pic, pic_salva, pic_restaura);
+  for (char t = 'A'; t <= 'D'; t++) {
+    instantaneo_registra(hw->inst, console_terminal(hw->console, t),
+                         terminal_salva, terminal_restaura);
+  }
+  controle_define_instantaneo(hw->controle, hw->inst);
 }
 
 static void destroi_hardware(hardware_t *hw)
 {
+  instantaneo_destroi(hw->inst);
   controle_destroi(hw->controle);
   cpu_destroi(hw->cpu);
   es_destroi(hw->es);
   relogio_destroi(hw->relogio);
+  pic_destroi(hw->pic);
   console_destroi(hw->console);
   mem_destroi(hw->mem);
+  rastro_destroi(hw->rastro);
 }
 
-int main()
+static void verifica_args(int argc, char *argv[argc])
+{
+  for (int argi = 1; argi < argc; argi++) {
+    if (strcmp(argv[argi], "-r") == 0) {
+      argi++;
+      if (argi >= argc) {
+        fprintf(stderr, "ERRO: falta nome do arquivo após '-r'\n");
+        exit(1);
+      }
+      nome_rastro = argv[argi];
+    } else if (strcmp(argv[argi], "-e") == 0) {
+      argi++;
+      if (argi >= argc) {
+        fprintf(stderr, "ERRO: falta nome do escalonador após '-e'\n");
+        exit(1);
+      }
+      nome_escalonador = argv[argi];
+    } else {
+      fprintf(stderr, "ERRO: chame como '%s [-r arquivo_de_rastro] [-e escalonador]'\n",
+              argv[0]);
+      exit(1);
+    }
+  }
+}
+
+int main(int argc, char *argv[argc])
 {
   hardware_t hw;
   so_t *so;
 
+  verifica_args(argc, argv);
+
   // cria o hardware
   cria_hardware(&hw);
   // cria o sistema operacional
   so = so_cria(hw.cpu, hw.mem, hw.es, hw.console);
+  so_define_rastro(so, hw.rastro);
+  if (nome_escalonador != NULL && !so_define_escalonador(so, nome_escalonador)) {
+    so_destroi(so);
+    destroi_hardware(&hw);
+    fprintf(stderr, "ERRO: escalonador '%s' não existe\n", nome_escalonador);
+    exit(1);
+  }
+  instantaneo_registra(hw.inst, so, so_salva, so_restaura);
 
   // executa o laço principal do controlador
   controle_laco(hw.controle);
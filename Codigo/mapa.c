@@ -0,0 +1,175 @@
+// mapa.c
+// mapa de chaves inteiras para ponteiros (tabela de espalhamento)
+// simulador de computador
+// so25b
+
+#include "mapa.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define CAP_INICIAL 16
+
+// estado de uma posição da tabela; as retiradas deixam uma marca, para não
+//   interromper a sondagem de chaves inseridas depois
+typedef enum { vazia, ocupada, removida } situacao_t;
+
+typedef struct {
+  int chave;
+  situacao_t situacao;
+  void *valor;
+} entrada_t;
+
+struct mapa_t {
+  entrada_t *tab;
+  int cap;             // potência de 2
+  int cap_tab;         // posições alocadas em tab (>= cap, ver mapa_restaura)
+  int n;               // posições ocupadas
+  int n_removidas;     // posições com marca de retirada
+};
+
+mapa_t *mapa_cria(void)
+{
+  mapa_t *self = malloc(sizeof(*self));
+  if (self == NULL) return NULL;
+  self->tab = calloc(CAP_INICIAL, sizeof(*self->tab));
+  if (self->tab == NULL) {
+    free(self);
+    return NULL;
+  }
+  self->cap = CAP_INICIAL;
+  self->cap_tab = CAP_INICIAL;
+  self->n = 0;
+  self->n_removidas = 0;
+  return self;
+}
+
+void mapa_destroi(mapa_t *self)
+{
+  free(self->tab);
+  free(self);
+}
+
+// posição inicial da sondagem da chave
+static int espalha(mapa_t *self, int chave)
+{
+  unsigned h = (unsigned)chave * 2654435769u;
+  return (h ^ (h >> 16)) & (self->cap - 1);
+}
+
+// posição da chave, ou -1 se não estiver no mapa
+static int posicao(mapa_t *self, int chave)
+{
+  for (int i = espalha(self, chave); ; i = (i + 1) & (self->cap - 1)) {
+    entrada_t *e = &self->tab[i];
+    if (e->situacao == vazia) return -1;
+    if (e->situacao == ocupada && e->chave == chave) return i;
+  }
+}
+
+// recria a tabela com capacidade 'cap', sem as marcas de retirada
+static bool refaz(mapa_t *self, int cap)
+{
+  entrada_t *nova = calloc(cap, sizeof(*nova));
+  if (nova == NULL) return false;
+  entrada_t *velha = self->tab;
+  int cap_velha = self->cap;
+  self->tab = nova;
+  self->cap = cap;
+  self->cap_tab = cap;
+  self->n_removidas = 0;
+  for (int i = 0; i < cap_velha; i++) {
+    if (velha[i].situacao != ocupada) continue;
+    int j = espalha(self, velha[i].chave);
+    while (nova[j].situacao == ocupada) j = (j + 1) & (cap - 1);
+    nova[j] = velha[i];
+  }
+  free(velha);
+  return true;
+}
+
+bool mapa_insere(mapa_t *self, int chave, void *valor)
+{
+  int i = posicao(self, chave);
+  if (i >= 0) {
+    self->tab[i].valor = valor;
+    return true;
+  }
+  // mantém pelo menos metade das posições vazias
+  if ((self->n + self->n_removidas + 1) * 2 > self->cap) {
+    int cap = (self->n + 1) * 4 > self->cap ? self->cap * 2 : self->cap;
+    if (!refaz(self, cap)) return false;
+  }
+  for (i = espalha(self, chave); self->tab[i].situacao == ocupada;
+       i = (i + 1) & (self->cap - 1)) {
+    ;
+  }
+  if (self->tab[i].situacao == removida) self->n_removidas--;
+  self->tab[i].chave = chave;
+  self->tab[i].situacao = ocupada;
+  self->tab[i].valor = valor;
+  self->n++;
+  return true;
+}
+
+void mapa_retira(mapa_t *self, int chave)
+{
+  int i = posicao(self, chave);
+  if (i < 0) return;
+  self->tab[i].situacao = removida;
+  self->tab[i].valor = NULL;
+  self->n--;
+  self->n_removidas++;
+}
+
+void *mapa_busca(mapa_t *self, int chave)
+{
+  int i = posicao(self, chave);
+  return i < 0 ? NULL : self->tab[i].valor;
+}
+
+int mapa_n(mapa_t *self)
+{
+  return self->n;
+}
+
+
+// ---------------------------------------------------------------------
+// INSTANTÂNEOS {{{1
+// ---------------------------------------------------------------------
+
+// o estado é a estrutura seguida da tabela
+// na recuperação a tabela não encolhe (só as primeiras 'cap' posições são
+//   usadas), então voltar para um estado salvo deste mapa não precisa de
+//   memória, a não ser que ele tenha sido salvo com outra tabela maior
+
+int mapa_tam_estado(mapa_t *self)
+{
+  return sizeof(mapa_t) + self->cap * sizeof(entrada_t);
+}
+
+void mapa_salva(mapa_t *self, void *estado)
+{
+  memcpy(estado, self, sizeof(mapa_t));
+  memcpy((char *)estado + sizeof(mapa_t), self->tab, self->cap * sizeof(entrada_t));
+}
+
+bool mapa_restaura(mapa_t *self, void *estado)
+{
+  // o estado pode não estar alinhado, é lido com memcpy
+  mapa_t salvo;
+  memcpy(&salvo, estado, sizeof(mapa_t));
+  if (salvo.cap > self->cap_tab) {
+    entrada_t *tab = realloc(self->tab, salvo.cap * sizeof(entrada_t));
+    if (tab == NULL) return false;
+    self->tab = tab;
+    self->cap_tab = salvo.cap;
+  }
+  self->cap = salvo.cap;
+  self->n = salvo.n;
+  self->n_removidas = salvo.n_removidas;
+  memcpy(self->tab, (char *)estado + sizeof(mapa_t), self->cap * sizeof(entrada_t));
+  return true;
+}
+
+// vim: foldmethod=marker
@@ -0,0 +1,43 @@
+// mapa.h
+// mapa de chaves inteiras para ponteiros (tabela de espalhamento)
+// simulador de computador
+// so25b
+
+#ifndef MAPA_H
+#define MAPA_H
+
+// Tabela de espalhamento com endereçamento aberto (sondagem linear). A
+//   tabela dobra de tamanho quando fica com mais da metade ocupada, e
+//   inserção, retirada e busca são O(1) em média.
+
+#include <stdbool.h>
+
+typedef struct mapa_t mapa_t;
+
+// cria um mapa vazio
+mapa_t *mapa_cria(void);
+
+// destrói o mapa (não mexe nos valores)
+void mapa_destroi(mapa_t *self);
+
+// associa 'valor' a 'chave' (substitui o valor anterior, se houver)
+// retorna false se faltar memória
+bool mapa_insere(mapa_t *self, int chave, void *valor);
+
+// retira a chave do mapa (se não estiver, não faz nada)
+void mapa_retira(mapa_t *self, int chave);
+
+// retorna o valor associado à chave, ou NULL se não houver
+void *mapa_busca(mapa_t *self, int chave);
+
+// número de chaves no mapa
+int mapa_n(mapa_t *self);
+
+// funções para salvar e recuperar o mapa em um instantâneo (o estado é
+//   salvo em 'estado', que deve ter mapa_tam_estado() bytes)
+// mapa_restaura retorna false, sem alterar o mapa, se faltar memória
+int mapa_tam_estado(mapa_t *self);
+void mapa_salva(mapa_t *self, void *estado);
+bool mapa_restaura(mapa_t *self, void *estado);
+
+#endif // MAPA_H
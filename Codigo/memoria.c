@@ -6,12 +6,25 @@
 #include "memoria.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 // tipo de dados para representar uma região de memória
 struct mem_t {
   int tam;
   int *conteudo;
+  int n_paginas;
+  // atributos de cada página (MEM_PAG_*)
+  unsigned char *atributos;
+  // função chamada nas escritas em páginas vigiadas
+  f_vigia_t f_vigia;
+  void *arg_vigia;
 };
 
 
@@ -28,6 +41,11 @@ mem_t *mem_cria(int tam)
 
   self->tam = tam;
 
+  self->n_paginas = (tam + MEM_TAM_PAGINA - 1) / MEM_TAM_PAGINA;
+  self->atributos = calloc(self->n_paginas, sizeof(*(self->atributos)));
+  assert(self->atributos != NULL);
+  self->f_vigia = NULL;
+
   return self;
 }
 
@@ -37,6 +55,7 @@ void mem_destroi(mem_t *self)
     if (self->conteudo != NULL) {
       free(self->conteudo);
     }
+    free(self->atributos);
     free(self);
   }
 }
@@ -64,11 +83,278 @@ err_t mem_le(mem_t *self, int endereco, int *pvalor)
   return err;
 }
 
+// escrita em página com atributos a tratar
+static err_t escreve_com_atributos(mem_t *self, int endereco, int valor)
+{
+  int pag = endereco / MEM_TAM_PAGINA;
+  int atrib = self->atributos[pag];
+  if (atrib & MEM_PAG_SO_LEITURA) {
+    return ERR_ESCR_PROT;
+  }
+  self->conteudo[endereco] = valor;
+  self->atributos[pag] = atrib | MEM_PAG_SUJA;
+  if ((atrib & MEM_PAG_VIGIADA) && self->f_vigia != NULL) {
+    self->f_vigia(self->arg_vigia, endereco, 1);
+  }
+  return ERR_OK;
+}
+
 err_t mem_escreve(mem_t *self, int endereco, int valor)
 {
   err_t err = verifica_permissao(self, endereco);
   if (err == ERR_OK) {
+    // caminho rápido: página já suja e sem outros atributos
+    if (self->atributos[endereco / MEM_TAM_PAGINA] != MEM_PAG_SUJA) {
+      return escreve_com_atributos(self, endereco, valor);
+    }
     self->conteudo[endereco] = valor;
   }
   return err;
 }
+
+
+// ---------------------------------------------------------------------
+// OPERAÇÕES EM BLOCO
+// ---------------------------------------------------------------------
+
+// as operações em bloco usam instruções vetoriais do hospedeiro, se o
+//   compilador tiver sido configurado para gerá-las (por exemplo, com
+//   -mavx2); senão, usam laços simples
+// MEM_VETOR é o número de valores processados em cada instrução vetorial
+
+#if defined(__AVX2__)
+#define MEM_VETOR 8
+typedef __m256i vetor_t;
+#define vet_le(p)         _mm256_loadu_si256((vetor_t *)(p))
+#define vet_escreve(p, v) _mm256_storeu_si256((vetor_t *)(p), v)
+#define vet_repete(x)     _mm256_set1_epi32(x)
+#define vet_soma(a, b)    _mm256_add_epi32(a, b)
+#define vet_zero()        _mm256_setzero_si256()
+#define vet_iguais(a, b)  _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)))
+#elif defined(__SSE2__)
+#define MEM_VETOR 4
+typedef __m128i vetor_t;
+#define vet_le(p)         _mm_loadu_si128((vetor_t *)(p))
+#define vet_escreve(p, v) _mm_storeu_si128((vetor_t *)(p), v)
+#define vet_repete(x)     _mm_set1_epi32(x)
+#define vet_soma(a, b)    _mm_add_epi32(a, b)
+#define vet_zero()        _mm_setzero_si128()
+#define vet_iguais(a, b)  _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)))
+#endif
+
+// máscara de vet_iguais quando todos os valores são iguais
+#define MEM_TODOS_IGUAIS ((1 << MEM_VETOR) - 1)
+
+// função auxiliar, verifica se todos os endereços da região são válidos
+static err_t verifica_regiao(mem_t *self, int endereco, int n)
+{
+  if (n < 0 || endereco < 0 || n > self->tam - endereco) {
+    return ERR_END_INV;
+  }
+  return ERR_OK;
+}
+
+// funções auxiliares para as escritas em bloco
+// antes de escrever, verifica_escrita_regiao vê se a região pode ser
+//   escrita; depois, suja_regiao marca as páginas como sujas e avisa
+//   das escritas em páginas vigiadas
+
+static err_t verifica_escrita_regiao(mem_t *self, int endereco, int n)
+{
+  err_t err = verifica_regiao(self, endereco, n);
+  if (err != ERR_OK || n == 0) return err;
+  int pag_fim = (endereco + n - 1) / MEM_TAM_PAGINA;
+  for (int p = endereco / MEM_TAM_PAGINA; p <= pag_fim; p++) {
+    if (self->atributos[p] & MEM_PAG_SO_LEITURA) return ERR_ESCR_PROT;
+  }
+  return ERR_OK;
+}
+
+static void suja_regiao(mem_t *self, int endereco, int n)
+{
+  int fim = endereco + n;
+  while (endereco < fim) {
+    int pag = endereco / MEM_TAM_PAGINA;
+    int fim_pag = (pag + 1) * MEM_TAM_PAGINA;
+    if (fim_pag > fim) fim_pag = fim;
+    int atrib = self->atributos[pag];
+    self->atributos[pag] = atrib | MEM_PAG_SUJA;
+    if ((atrib & MEM_PAG_VIGIADA) && self->f_vigia != NULL) {
+      self->f_vigia(self->arg_vigia, endereco, fim_pag - endereco);
+    }
+    endereco = fim_pag;
+  }
+}
+
+// função auxiliar, copia 'n' valores de 'origem' para 'destino'
+static void copia_valores(int *destino, int *origem, int n)
+{
+  int i = 0;
+#ifdef MEM_VETOR
+  for (; i + MEM_VETOR <= n; i += MEM_VETOR) {
+    vet_escreve(destino + i, vet_le(origem + i));
+  }
+#endif
+  for (; i < n; i++) {
+    destino[i] = origem[i];
+  }
+}
+
+err_t mem_preenche(mem_t *self, int endereco, int n, int valor)
+{
+  err_t err = verifica_escrita_regiao(self, endereco, n);
+  if (err != ERR_OK) return err;
+  int *p = self->conteudo + endereco;
+  int i = 0;
+#ifdef MEM_VETOR
+  vetor_t v = vet_repete(valor);
+  for (; i + MEM_VETOR <= n; i += MEM_VETOR) {
+    vet_escreve(p + i, v);
+  }
+#endif
+  for (; i < n; i++) {
+    p[i] = valor;
+  }
+  suja_regiao(self, endereco, n);
+  return ERR_OK;
+}
+
+err_t mem_copia(mem_t *self, int endereco, int *origem, int n)
+{
+  err_t err = verifica_escrita_regiao(self, endereco, n);
+  if (err != ERR_OK) return err;
+  copia_valores(self->conteudo + endereco, origem, n);
+  suja_regiao(self, endereco, n);
+  return ERR_OK;
+}
+
+err_t mem_le_bloco(mem_t *self, int endereco, int *destino, int n)
+{
+  err_t err = verifica_regiao(self, endereco, n);
+  if (err != ERR_OK) return err;
+  copia_valores(destino, self->conteudo + endereco, n);
+  return ERR_OK;
+}
+
+err_t mem_compara(mem_t *self, int endereco, int *dados, int n, int *pdif)
+{
+  err_t err = verifica_regiao(self, endereco, n);
+  if (err != ERR_OK) return err;
+  int *p = self->conteudo + endereco;
+  int i = 0;
+#ifdef MEM_VETOR
+  for (; i + MEM_VETOR <= n; i += MEM_VETOR) {
+    int iguais = vet_iguais(vet_le(p + i), vet_le(dados + i));
+    if (iguais != MEM_TODOS_IGUAIS) {
+      // o primeiro bit desligado é o do primeiro valor diferente
+      *pdif = i + __builtin_ctz(~iguais);
+      return ERR_OK;
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    if (p[i] != dados[i]) {
+      *pdif = i;
+      return ERR_OK;
+    }
+  }
+  *pdif = -1;
+  return ERR_OK;
+}
+
+// a soma de Fletcher é s1 = x0 + x1 + ... e s2 = n*x0 + (n-1)*x1 + ...
+//   (s2 acumula os valores de s1 após cada valor).
+// na versão vetorial, cada posição j do vetor acumula sua própria s1 e s2,
+//   sobre os valores j, j+MEM_VETOR, j+2*MEM_VETOR...; no final, como o
+//   valor na posição j de um bloco tem peso MEM_VETOR vezes o número de
+//   blocos restantes menos j, s2 = soma de (MEM_VETOR * s2[j] - j * s1[j])
+err_t mem_checksum(mem_t *self, int endereco, int n, unsigned int *psoma)
+{
+  err_t err = verifica_regiao(self, endereco, n);
+  if (err != ERR_OK) return err;
+  int *p = self->conteudo + endereco;
+  unsigned int s1 = 0, s2 = 0;
+  int i = 0;
+#ifdef MEM_VETOR
+  vetor_t v1 = vet_zero();
+  vetor_t v2 = vet_zero();
+  for (; i + MEM_VETOR <= n; i += MEM_VETOR) {
+    v1 = vet_soma(v1, vet_le(p + i));
+    v2 = vet_soma(v2, v1);
+  }
+  unsigned int a1[MEM_VETOR], a2[MEM_VETOR];
+  vet_escreve(a1, v1);
+  vet_escreve(a2, v2);
+  for (int j = 0; j < MEM_VETOR; j++) {
+    s1 += a1[j];
+    s2 += MEM_VETOR * a2[j] - j * a1[j];
+  }
+#endif
+  for (; i < n; i++) {
+    s1 += p[i];
+    s2 += s1;
+  }
+  *psoma = s1 ^ ((s2 << 16) | (s2 >> 16));
+  return ERR_OK;
+}
+
+
+// ---------------------------------------------------------------------
+// ATRIBUTOS DAS PÁGINAS
+// ---------------------------------------------------------------------
+
+int mem_n_paginas(mem_t *self)
+{
+  return self->n_paginas;
+}
+
+int mem_atributos(mem_t *self, int pagina)
+{
+  if (pagina < 0 || pagina >= self->n_paginas) return 0;
+  return self->atributos[pagina];
+}
+
+// função auxiliar, limita a faixa de páginas às existentes
+static void limita_paginas(mem_t *self, int *ppagina, int *pn)
+{
+  if (*ppagina < 0) {
+    *pn += *ppagina;
+    *ppagina = 0;
+  }
+  if (*pn > self->n_paginas - *ppagina) *pn = self->n_paginas - *ppagina;
+}
+
+void mem_liga_atributos(mem_t *self, int pagina, int n, int atrib)
+{
+  limita_paginas(self, &pagina, &n);
+  for (int p = pagina; p < pagina + n; p++) {
+    self->atributos[p] |= atrib;
+  }
+}
+
+void mem_desliga_atributos(mem_t *self, int pagina, int n, int atrib)
+{
+  limita_paginas(self, &pagina, &n);
+  for (int p = pagina; p < pagina + n; p++) {
+    self->atributos[p] &= ~atrib;
+  }
+}
+
+void mem_define_vigia(mem_t *self, f_vigia_t f_vigia, void *arg)
+{
+  self->f_vigia = f_vigia;
+  self->arg_vigia = arg;
+}
+
+int mem_proxima_pagina_suja(mem_t *self, int pagina)
+{
+  for (int p = pagina < 0 ? 0 : pagina; p < self->n_paginas; p++) {
+    if (self->atributos[p] & MEM_PAG_SUJA) return p;
+  }
+  return -1;
+}
+
+void mem_limpa_paginas_sujas(mem_t *self)
+{
+  mem_desliga_atributos(self, 0, self->n_paginas, MEM_PAG_SUJA);
+}
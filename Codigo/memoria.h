@@ -6,13 +6,29 @@
 
 // A memória é um vetor de inteiros, com um inteiro em cada posição, entre 0
 //   e tam-1 (tam é o tamanho da memória, especificado na criação).
-// Tem só 3 operações:
+// Tem só 3 operações básicas:
 // - obter o tamanho da memória
 // - obter o valor do inteiro que está em uma das posições
 // - alterar o valor o inteiro que está em uma das posições
+// E operações em bloco, para uso pelo SO e pelo simulador (carga de
+//   programas, limpeza de regiões, comparação e verificação de conteúdo).
+//   Essas operações verificam os limites da região uma só vez, e usam
+//   instruções vetoriais do hospedeiro (AVX2 ou SSE2, se o compilador
+//   tiver habilitado) para processar vários valores por vez.
 //
-// O único erro possível no acesso é uma tentativa de acesso a uma posição
-//   inexistente
+// A memória é dividida em páginas de MEM_TAM_PAGINA valores, e cada página
+//   tem atributos:
+// - suja: a página foi alterada desde a última limpeza, para que se possa
+//   salvar só o que mudou (ver instantaneo.h)
+// - só de leitura: as escritas na página são recusadas
+// - vigiada: as escritas na página são informadas a uma função definida com
+//   mem_define_vigia
+// A escrita em uma página que já está suja e não tem outros atributos é
+//   feita diretamente; as demais passam por um caminho mais lento, que trata
+//   os atributos.
+//
+// Os erros possíveis no acesso são uma tentativa de acesso a uma posição
+//   inexistente ou de escrita em uma página só de leitura
 
 #ifndef MEMORIA_H
 #define MEMORIA_H
@@ -22,6 +38,19 @@
 // tipo opaco que representa a memória
 typedef struct mem_t mem_t;
 
+// número de valores em uma página da memória
+#define MEM_TAM_PAGINA 64
+
+// atributos de uma página
+#define MEM_PAG_SUJA       0x01
+#define MEM_PAG_SO_LEITURA 0x02
+#define MEM_PAG_VIGIADA    0x04
+
+// tipo da função chamada quando há escrita em página vigiada
+// recebe o argumento definido em mem_define_vigia e a região alterada
+//   ('n' valores a partir de 'endereco', todos na mesma página)
+typedef void (*f_vigia_t)(void *arg, int endereco, int n);
+
 // cria uma região de memória com capacidade para 'tam' valores (inteiros)
 // retorna um ponteiro para um descritor, que deverá ser usado em todas
 //   as operações sobre essa memória
@@ -39,7 +68,57 @@ int mem_tam(mem_t *self);
 err_t mem_le(mem_t *self, int endereco, int *pvalor);
 
 // coloca 'valor' no endereço 'endereco' da memória
-// retorna erro ERR_END_INV se endereço inválido
+// retorna erro ERR_END_INV se endereço inválido ou ERR_ESCR_PROT se a
+//   página for só de leitura
 err_t mem_escreve(mem_t *self, int endereco, int valor);
 
+// operações em bloco
+// todas retornam ERR_END_INV (e não fazem nada) se alguma das 'n' posições
+//   a partir de 'endereco' for inválida; as que escrevem retornam
+//   ERR_ESCR_PROT (e não fazem nada) se alguma página for só de leitura
+
+// coloca 'valor' nas 'n' posições a partir de 'endereco'
+err_t mem_preenche(mem_t *self, int endereco, int n, int valor);
+
+// copia os 'n' valores em 'origem' para a memória, a partir de 'endereco'
+err_t mem_copia(mem_t *self, int endereco, int *origem, int n);
+
+// compara os 'n' valores da memória a partir de 'endereco' com os de 'dados'
+// coloca em '*pdif' a posição (relativa a 'endereco') do primeiro valor
+//   diferente, ou -1 se forem todos iguais
+err_t mem_compara(mem_t *self, int endereco, int *dados, int n, int *pdif);
+
+// copia para 'destino' os 'n' valores da memória a partir de 'endereco'
+err_t mem_le_bloco(mem_t *self, int endereco, int *destino, int n);
+
+// calcula uma soma de verificação (tipo Fletcher) dos 'n' valores a partir
+//   de 'endereco', e coloca em '*psoma'
+err_t mem_checksum(mem_t *self, int endereco, int n, unsigned int *psoma);
+
+// atributos das páginas
+// uma página fica suja quando algum valor nela é alterado
+
+// retorna o número de páginas da memória (a última pode ser incompleta)
+int mem_n_paginas(mem_t *self);
+
+// retorna os atributos da página
+int mem_atributos(mem_t *self, int pagina);
+
+// liga ou desliga os atributos em 'atrib' nas 'n' páginas a partir de 'pagina'
+void mem_liga_atributos(mem_t *self, int pagina, int n, int atrib);
+void mem_desliga_atributos(mem_t *self, int pagina, int n, int atrib);
+
+// define a função a chamar (e seu argumento) nas escritas em páginas vigiadas
+void mem_define_vigia(mem_t *self, f_vigia_t f_vigia, void *arg);
+
+// retorna o número da primeira página suja a partir de 'pagina' (inclusive),
+//   ou -1 se não houver
+// para percorrer as páginas sujas:
+//   for (p = mem_proxima_pagina_suja(mem, 0); p != -1;
+//        p = mem_proxima_pagina_suja(mem, p + 1)) ...
+int mem_proxima_pagina_suja(mem_t *self, int pagina);
+
+// marca todas as páginas como limpas
+void mem_limpa_paginas_sujas(mem_t *self);
+
 #endif // MEMORIA_H
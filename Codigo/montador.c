@@ -76,19 +76,68 @@ void mem_altera(int pos, int val)
   mem[pos] = val;
 }
 
-// imprime o conteúdo da memória
-void mem_imprime(void)
+// regiões não inicializadas (BSS), geradas por 'ESPACO'
+// não são impressas com os dados, só seu início e tamanho, e o carregador
+//   as preenche com zeros
+// regiões menores que BSS_MIN são impressas como dados (a linha de BSS
+//   ocuparia mais que os zeros)
+
+#define BSS_MIN 8
+#define BSS_TAM 1000
+struct {
+  int ini;
+  int tam;
+} bss[BSS_TAM];
+int bss_num;      // número de regiões BSS
+
+// registra uma região não inicializada de 'tam' posições em 'ini'
+// regiões contíguas são juntadas em uma só
+void bss_nova(int ini, int tam)
 {
-  printf("//MAQ %d %d\n", mem_max - mem_min + 1, mem_min);
-  for (int i = mem_min; i <= mem_max; i+=10) {
+  if (bss_num > 0 && bss[bss_num-1].ini + bss[bss_num-1].tam == ini) {
+    bss[bss_num-1].tam += tam;
+    return;
+  }
+  if (bss_num >= BSS_TAM) {
+    erro_brabo("excesso de regiões BSS. Aumente BSS_TAM no montador.");
+  }
+  bss[bss_num].ini = ini;
+  bss[bss_num].tam = tam;
+  bss_num++;
+}
+
+// imprime os valores das posições [ini, fim) da memória, 10 por linha
+void mem_imprime_trecho(int ini, int fim)
+{
+  for (int i = ini; i < fim; i+=10) {
     printf("[%4d] =", i);
-    for (int j = i; j < i+10 && j <= mem_max; j++) {
+    for (int j = i; j < i+10 && j < fim; j++) {
       printf(" %d,", mem[j]);
     }
     printf("\n");
   }
 }
 
+// imprime o conteúdo da memória
+// após o cabeçalho vêm as regiões BSS, uma por linha ("//BSS início tamanho"),
+//   depois os dados das demais posições
+void mem_imprime(void)
+{
+  printf("//MAQ %d %d\n", mem_max - mem_min + 1, mem_min);
+  for (int b = 0; b < bss_num; b++) {
+    if (bss[b].tam >= BSS_MIN) {
+      printf("//BSS %d %d\n", bss[b].ini, bss[b].tam);
+    }
+  }
+  int ini = mem_min;
+  for (int b = 0; b < bss_num; b++) {
+    if (bss[b].tam < BSS_MIN) continue;
+    mem_imprime_trecho(ini, bss[b].ini);
+    ini = bss[b].ini + bss[b].tam;
+  }
+  mem_imprime_trecho(ini, mem_max + 1);
+}
+
 
 // ---------------------------------------------------------------------
 // SÍMBOLOS {{{1
@@ -196,6 +245,7 @@ void monta_instrucao(int linha, int opcode, char *arg)
               linha);
       return;
     }
+    bss_nova(mem_pos, argn);
     for (int i = 0; i < argn; i++) {
       mem_insere(0);
     }
@@ -0,0 +1,164 @@
+// pic.c
+// controlador programável de interrupções
+// simulador de computador
+// so25b
+
+#include "pic.h"
+#include "cpu.h"
+
+#include <stdlib.h>
+#include <assert.h>
+
+struct pic_t {
+  // máscaras de bits das linhas (ver pic.h)
+  int pendentes;
+  int em_servico;
+  int mascara;
+  // prioridade e vetor de cada linha
+  int prioridade[N_IRQ];
+  int vetor[N_IRQ];
+};
+
+pic_t *pic_cria(void)
+{
+  pic_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+
+  self->pendentes = 0;
+  self->em_servico = 0;
+  self->mascara = 0;
+  for (int irq = 0; irq < N_IRQ; irq++) {
+    self->prioridade[irq] = irq;
+    self->vetor[irq] = 0;
+  }
+
+  return self;
+}
+
+void pic_destroi(pic_t *self)
+{
+  free(self);
+}
+
+static bool irq_valida(int irq)
+{
+  return irq >= 0 && irq < N_IRQ;
+}
+
+void pic_pede(pic_t *self, irq_t irq)
+{
+  if (!irq_valida(irq)) return;
+  self->pendentes |= 1 << irq;
+}
+
+// a linha de maior prioridade (menor valor) entre as da máscara 'linhas',
+//   ou -1 se não tiver nenhuma
+static int mais_prioritaria(pic_t *self, int linhas)
+{
+  int escolhida = -1;
+  for (int irq = 0; irq < N_IRQ; irq++) {
+    if ((linhas & (1 << irq)) == 0) continue;
+    if (escolhida == -1 || self->prioridade[irq] < self->prioridade[escolhida]) {
+      escolhida = irq;
+    }
+  }
+  return escolhida;
+}
+
+bool pic_interrupcao(pic_t *self, irq_t *pirq, int *pend)
+{
+  int irq = mais_prioritaria(self, self->pendentes & ~self->mascara);
+  if (irq == -1) return false;
+  // só interrompe um atendimento de prioridade menor
+  int atendendo = mais_prioritaria(self, self->em_servico);
+  if (atendendo != -1 && self->prioridade[atendendo] <= self->prioridade[irq]) {
+    return false;
+  }
+  *pirq = irq;
+  *pend = self->vetor[irq] != 0 ? self->vetor[irq] : CPU_END_TRATADOR;
+  return true;
+}
+
+void pic_aceita(pic_t *self, irq_t irq)
+{
+  if (!irq_valida(irq)) return;
+  self->pendentes &= ~(1 << irq);
+  self->em_servico |= 1 << irq;
+}
+
+err_t pic_leitura(void *disp, int id, int *pvalor)
+{
+  pic_t *self = disp;
+  if (id >= PIC_PRIORIDADE && id < PIC_VETOR) {
+    *pvalor = self->prioridade[id - PIC_PRIORIDADE];
+    return ERR_OK;
+  }
+  if (id >= PIC_VETOR && id < PIC_N_DISP) {
+    *pvalor = self->vetor[id - PIC_VETOR];
+    return ERR_OK;
+  }
+  switch (id) {
+    case PIC_PENDENTES:
+      *pvalor = self->pendentes;
+      break;
+    case PIC_EM_SERVICO:
+      *pvalor = self->em_servico;
+      break;
+    case PIC_MASCARA:
+      *pvalor = self->mascara;
+      break;
+    case PIC_ACK:
+    case PIC_EOI:
+      return ERR_OP_INV;
+    default:
+      return ERR_DISP_INV;
+  }
+  return ERR_OK;
+}
+
+err_t pic_escrita(void *disp, int id, int valor)
+{
+  pic_t *self = disp;
+  if (id >= PIC_PRIORIDADE && id < PIC_VETOR) {
+    self->prioridade[id - PIC_PRIORIDADE] = valor;
+    return ERR_OK;
+  }
+  if (id >= PIC_VETOR && id < PIC_N_DISP) {
+    self->vetor[id - PIC_VETOR] = valor;
+    return ERR_OK;
+  }
+  switch (id) {
+    case PIC_MASCARA:
+      self->mascara = valor;
+      break;
+    case PIC_ACK:
+      if (!irq_valida(valor)) return ERR_OP_INV;
+      if ((self->pendentes & (1 << valor)) == 0) return ERR_OCUP;
+      pic_aceita(self, valor);
+      break;
+    case PIC_EOI:
+      if (!irq_valida(valor)) return ERR_OP_INV;
+      self->em_servico &= ~(1 << valor);
+      break;
+    case PIC_PENDENTES:
+    case PIC_EM_SERVICO:
+      return ERR_OP_INV;
+    default:
+      return ERR_DISP_INV;
+  }
+  return ERR_OK;
+}
+
+void *pic_salva(void *self)
+{
+  pic_t *copia = malloc(sizeof(*copia));
+  assert(copia != NULL);
+  *copia = *(pic_t *)self;
+  return copia;
+}
+
+bool pic_restaura(void *self, void *estado)
+{
+  *(pic_t *)self = *(pic_t *)estado;
+  return true;
+}
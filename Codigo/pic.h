@@ -0,0 +1,79 @@
+// pic.h
+// controlador programável de interrupções
+// simulador de computador
+// so25b
+
+#ifndef PIC_H
+#define PIC_H
+
+// simulação de um controlador de interrupções (PIC)
+//
+// fica entre os dispositivos e a CPU: os pedidos de interrupção dos
+//   dispositivos são registrados no PIC (pic_pede), e ficam pendentes até
+//   serem aceitos, então nenhum pedido é perdido quando a CPU está em modo
+//   supervisor e recusa a interrupção. pedidos repetidos de uma linha que
+//   ainda está pendente se juntam em um só.
+// cada IRQ é uma linha do PIC, que pode ser mascarada (fica pendente mas não
+//   é entregue à CPU) e tem uma prioridade (menor valor, maior prioridade; por
+//   padrão, a prioridade é o número da IRQ).
+// quando uma interrupção é aceita (pela CPU ou pelo SO, com PIC_ACK), a linha
+//   deixa de estar pendente e passa a estar em serviço até o fim do
+//   atendimento (PIC_EOI); enquanto isso, só linhas de prioridade maior são
+//   entregues à CPU.
+// cada linha tem um vetor, o endereço do tratador em que a CPU deve entrar
+//   ao aceitar essa interrupção (0 para o tratador padrão, CPU_END_TRATADOR).
+//
+// o SO programa e consulta o PIC através do controlador de E/S. a leitura
+//   dos pendentes permite que o SO atenda de uma só vez várias interrupções
+//   pedidas, confirmando cada uma com PIC_ACK.
+
+#include <stdbool.h>
+#include "err.h"
+#include "irq.h"
+
+typedef struct pic_t pic_t;
+
+// os dispositivos do PIC, com a representação das linhas em máscaras de bits
+//   (o bit 1<<irq representa a linha da IRQ irq)
+#define PIC_PENDENTES   0   // (leitura) linhas com pedido pendente
+#define PIC_EM_SERVICO  1   // (leitura) linhas aceitas e ainda sem EOI
+#define PIC_MASCARA     2   // (leitura e escrita) linhas mascaradas
+#define PIC_ACK         3   // (escrita) aceita o pedido pendente da IRQ escrita
+#define PIC_EOI         4   // (escrita) fim do atendimento da IRQ escrita
+#define PIC_PRIORIDADE  5   // (leitura e escrita) PIC_PRIORIDADE+irq é a
+                            //   prioridade da linha irq
+#define PIC_VETOR       (PIC_PRIORIDADE + N_IRQ)
+                            // (leitura e escrita) PIC_VETOR+irq é o vetor da
+                            //   linha irq
+#define PIC_N_DISP      (PIC_VETOR + N_IRQ)
+
+// cria e inicializa um PIC, sem pedidos e sem máscara
+pic_t *pic_cria(void);
+
+// destrói um PIC
+void pic_destroi(pic_t *self);
+
+// registra um pedido de interrupção na linha irq
+// (para uso pelo controlador, em nome dos dispositivos)
+void pic_pede(pic_t *self, irq_t irq);
+
+// retorna true se há uma interrupção a entregar à CPU, e coloca em *pirq a
+//   de maior prioridade e em *pend o endereço do seu tratador
+// (para uso pelo controlador, que deve chamar pic_aceita se a CPU aceitar)
+bool pic_interrupcao(pic_t *self, irq_t *pirq, int *pend);
+
+// a interrupção irq foi aceita pela CPU
+void pic_aceita(pic_t *self, irq_t irq);
+
+// Funções para acessar o PIC como dispositivo de E/S, com id entre os
+//   PIC_* acima
+// Devem seguir o protocolo f_leitura_t e f_escrita_t declarados em es.h
+err_t pic_leitura(void *disp, int id, int *pvalor);
+err_t pic_escrita(void *disp, int id, int valor);
+
+// funções para salvar e recuperar o estado do PIC em um instantâneo
+//   (seguem o protocolo f_salva_t e f_restaura_t de instantaneo.h)
+void *pic_salva(void *self);
+bool pic_restaura(void *self, void *estado);
+
+#endif // PIC_H
@@ -24,23 +24,52 @@ processo_t* inicializa_processo(processo_t* processo, int id, int PC, int tam){
     processo->prio = 0.5;
     processo->id_terminal = (id % 4) * 4;     //0-3, 4-7, 8-11, 12-15
     processo->espera_terminal = 0;     //Sem espera = 0, Le = 1, Escreve = 2
+    processo->bloqueio = bloq_terminal;
     processo->quantum = QUANTUM_INICIAL;
+    processo->fp_prox = NULL;
+    processo->fp_ant = NULL;
+    processo->fp_nivel = FP_FORA;
+    processo->t_despacho = 0;
+    processo->instrucoes = 0;
+    processo->vruntime = 0;
+    processo->t_entrada_pronto = 0;
+    processo->t_executavel = 0;
+    heap_inicializa_no(&processo->no_heap);
+    processo->nivel_mlfq = 0;
+    processo->bilhetes = BILHETES_PADRAO;
+    processo->passada = 0;
+    processo->passo = PASSADA_UM / BILHETES_PADRAO;
+    processo->surto_previsto = SURTO_INICIAL;
+    processo->erro_previsao = 0;
+    processo->t_criacao = 0;
+    inicializa_tempo_real(&processo->tr);
+    heap_inicializa_no(&processo->no_tempo_real);
+    heap_inicializa_no(&processo->no_liberacao);
+    processo->grupo = id;
+    processo->cota = 0;
+    processo->usado_cota = 0;
+    processo->estrangulado = false;
+    lista_inicializa_no(&processo->no_cota);
+    processo->n_estrangulamentos = 0;
+    lista_inicializa_no(&processo->no_espera);
+    processo->fila_espera = NULL;
+    lista_inicializa(&processo->esperando_fim);
+    roda_inicializa_no(&processo->no_dorme);
     return processo;
 }
 
-int encontra_indice_processo(processo_t processos[MAX_PROCESSOS], int id){
-    for(int i = 0; i < MAX_PROCESSOS; i++){
-        if(processos[i].id == id)
-            return i;
-    }
-    return -1;
-}
-
-void altera_estado_proc_tabela(processo_t processos[MAX_PROCESSOS], int id, estado_proc estado){
-    int indice = encontra_indice_processo(processos, id);
-    if(indice != -1){
-        processos[indice].estado = estado;
-    }
+void inicializa_tempo_real(tempo_real_t* tr){
+    tr->periodo = 0;
+    tr->orcamento = 0;
+    tr->restante = 0;
+    tr->prazo = 0;
+    tr->liberacao = 0;
+    tr->ativo = false;
+    tr->n_jobs = 0;
+    tr->n_perdas = 0;
+    tr->atraso_max = 0;
+    for(int i = 0; i < N_FAIXAS_ATRASO; i++)
+        tr->atrasos[i] = 0;
 }
 
 static char *nomes_estados[3] = {
@@ -57,217 +86,75 @@ char *estado_nome(estado_proc est)
 }
 
 // ---------------------------------------------------------------------
-// LISTA DE PROCESSOS
-// ---------------------------------------------------------------------
-
-void lst_libera(Lista_processos* l){
-    Lista_processos* p = l;
-    while(p != NULL){
-        Lista_processos* t = p->prox;
-        free(p);
-        p = t;
-    }
-}
-
-void lst_imprime(Lista_processos* l){
-    Lista_processos* p;
-    for (p = l; p != NULL; p = p->prox)
-        console_printf("pid = %d prio = %.2f estado = %d\n", p->id, p->prio, p->estado);
-}
-
-int lst_vazia(Lista_processos* l){
-    return (l == NULL);
-}
-
-Lista_processos* lst_altera_estado(Lista_processos* l, int id, estado_proc estado){
-    Lista_processos* p;
-    for(p = l; p != NULL; p = p->prox){
-        if(p->id == id){
-            p->estado = estado;
-            return l;
-        }
-    }
-    return l; //id invalido, lista inalterada
-}
-
-Lista_processos* lst_insere_ordenado(Lista_processos* l, int id, float prio){
-    Lista_processos* novo;
-    Lista_processos* ant = NULL; /* ponteiro para elemento anterior */
-    Lista_processos* p = l; /* ponteiro para percorrer a lista */
-    /* procura posição de inserção */
-    while (p != NULL && p->prio <= prio){ 
-        ant = p; 
-        p = p->prox; 
-    }
-    /* cria novo elemento */
-    novo = (Lista_processos*)malloc(sizeof(Lista_processos));
-    novo->id = id;
-    novo->prio = prio;
-    novo->estado = pronto;
-    /* encadeia elemento */
-    if (ant == NULL){
-        novo->prox = l; 
-        l = novo; 
-    }
-    else {
-        novo->prox = ant->prox;
-        ant->prox = novo; 
-    }
-    return l;
-}
-
-Lista_processos* lst_adicionar_final(Lista_processos* l, int id, float prio){
-    console_printf("(proc_id adicionar %d)", id);
-	Lista_processos* p = (Lista_processos*)malloc(sizeof(Lista_processos));
-	if(p == NULL){
-		printf("\nFalha ao alocar memoria\n");
-		return NULL;
-	}
-    else{
-        Lista_processos* aux = l;
-        p->id = id;
-        p->prio = prio;
-        p->prox = NULL;
-        if(!lst_vazia(l)){
-            while(aux->prox != NULL) 
-                aux = aux->prox;
-            aux->prox = p;
-            console_printf("aux id: %d prox id: %d", aux->id, aux->prox->id);
-        }
-        else{
-            l = p;
-        }
-        console_printf("(proc_adicionado_final %d)", p->id);
-    }
-	return l;
-}
-
-Lista_processos* lst_retira(Lista_processos* l, int id){
-    Lista_processos* ant = NULL;
-    Lista_processos* p = l;
-    while (p != NULL){ 
-        if (p->id == id || p->estado == morto)
-            break;
-        ant = p;
-        p = p->prox; 
-    }
-    if (p == NULL)
-        return l;
-    if (ant == NULL){
-        l = p->prox; }
-    else { 
-        ant->prox = p->prox; 
-    }
-    free(p);
-    return l;
-}
-
-Lista_processos* lst_busca(Lista_processos* l, int id){
-    Lista_processos* p;
-    for (p = l; p != NULL; p = p->prox){
-        if(p->id == id)
-            return p;
-    }
-    return NULL;
-}
-
-// ---------------------------------------------------------------------
-// LISTA DE HISTORICO DE PROCESSOS
+// HISTORICO DE PROCESSOS
 // ---------------------------------------------------------------------
 
-Historico_processos* inicializa_historico_proc(int id, int tempo){
-    Historico_processos* novo = (Historico_processos*)malloc(sizeof(Historico_processos));
-    if(!novo) return NULL; 
-
-    novo->id = id;
-    novo->tempo_vida = tempo;
-    novo->n_preempcoes = 0;
-    novo->tempo_espera = 0;
-    novo->tempo_desde_ult_estado = tempo;
+void inicializa_historico_proc(Historico_processos* h, int id, int tempo){
+    h->id = id;
+    h->tempo_vida = tempo;
+    h->t_criacao = tempo;
+    h->t_morte = -1;
+    h->n_preempcoes = 0;
+    h->tempo_espera = 0;
+    h->tempo_desde_ult_estado = tempo;
+    h->instrucoes = 0;
+    h->t_executavel = 0;
+    h->bilhetes = 0;
+    h->n_surtos = 0;
+    h->erro_previsao = 0;
+    h->retorno = 0;
+    inicializa_tempo_real(&h->tr);
+    h->grupo = id;
+    h->cota = 0;
+    h->n_estrangulamentos = 0;
     for(int i = 0; i < TIPOS_IRQ; i++){
-        novo->quant_irq[i] = 0;
+        h->quant_irq[i] = 0;
     }
     for(int i = 0; i < TIPOS_ESTADOS; i++){
-        novo->tempo_estado[i] = 0;
-        novo->quant_estado[i] = 0;
-    }
-    novo->prox = NULL;
-    return novo;
-} 
-
-void hst_libera(Historico_processos* h){
-    Historico_processos* p = h;
-    while(p != NULL){
-        Historico_processos* t = p->prox;
-        free(p);
-        p = t;
+        h->tempo_estado[i] = 0;
+        h->quant_estado[i] = 0;
     }
 }
 
-void hst_imprime(Historico_processos* h){
-    Historico_processos* p;
-    for (p = h; p != NULL; p = p->prox)
-        console_printf("pid = %d tempo de vida = %.2f preempcoes = %d\n", p->id, p->tempo_vida, p->n_preempcoes);
+bool hst_inicializa(Historicos* hs){
+    hs->v = malloc(HST_CAP_INICIAL * sizeof(Historico_processos));
+    hs->n = 0;
+    hs->cap = hs->v == NULL ? 0 : HST_CAP_INICIAL;
+    return hs->v != NULL;
 }
 
-int hst_vazia(Historico_processos* h){
-    return (h == NULL);
+void hst_libera(Historicos* hs){
+    free(hs->v);
+    hs->v = NULL;
+    hs->n = hs->cap = 0;
 }
 
-Historico_processos* hst_insere_ordenado (Historico_processos* h, int id, int tempo){
-    Historico_processos* ant = NULL; 
-    Historico_processos* p = h; /* ponteiro para percorrer a lista */
-    /* procura posição de inserção */
-    while (p != NULL && p->id > id){ 
-        ant = p; 
-        p = p->prox; 
-    }
-    /* cria novo elemento */
-    Historico_processos* novo = inicializa_historico_proc(id, tempo);
-    if(novo == NULL) return h; //retorna lista inalterada
-    /* encadeia elemento */
-    if (ant == NULL){
-        novo->prox = h; 
-        h = novo; 
-    }
-    else {
-        novo->prox = ant->prox;
-        ant->prox = novo; 
-    }
-    return h;
+/*garante espaco para n historicos*/
+bool hst_reserva(Historicos* hs, int n){
+    if(n <= hs->cap)
+        return true;
+    int cap = hs->cap > 0 ? hs->cap : HST_CAP_INICIAL;
+    while(cap < n)
+        cap *= 2;
+    Historico_processos* v = realloc(hs->v, cap * sizeof(Historico_processos));
+    if(v == NULL)
+        return false;
+    hs->v = v;
+    hs->cap = cap;
+    return true;
 }
 
-Historico_processos* hst_retira(Historico_processos* h, int id){
-    Historico_processos* ant = NULL;
-    Historico_processos* p = h;
-    while (p != NULL){ 
-        if (p->id == id)
-            break;
-        ant = p;
-        p = p->prox; 
-    }
-    if (p == NULL)
-        return h;
-    if (ant == NULL){
-        h = p->prox; }
-    else { 
-        ant->prox = p->prox; 
-    }
-    free(p);
+/*o id deve ser o proximo pid (hs->n); retorna NULL se faltar memoria*/
+Historico_processos* hst_insere(Historicos* hs, int id, int tempo){
+    if(id != hs->n || !hst_reserva(hs, hs->n + 1))
+        return NULL;
+    Historico_processos* h = &hs->v[hs->n++];
+    inicializa_historico_proc(h, id, tempo);
     return h;
 }
 
-Historico_processos* hst_busca(Historico_processos* h, int id){
-    Historico_processos* p;
-    for (p = h; p != NULL; p = p->prox){
-        if(p->id == id)
-            return p;
-    }
-    return NULL;
+Historico_processos* hst_busca(Historicos* hs, int id){
+    if(id < 0 || id >= hs->n)
+        return NULL;
+    return &hs->v[id];
 }
-
-Historico_processos* hst_atualiza_preempcoes(Historico_processos* h, int id){
-    Historico_processos* p = hst_busca(h, id);
-    p->n_preempcoes++;
-    return h;
-}
\ No newline at end of file
@@ -2,11 +2,39 @@
 #define PROCESSO_H
 
 #include "so.h"
+#include "heap.h"
+#include "lista.h"
+#include "roda.h"
 
 #define INI_MEM_PROC 100
-#define MAX_PROCESSOS 4 //número máximo de processos
+/*quanto avanca por instrucao, no escalonador passada, um processo com um
+  bilhete; em ponto fixo grande para que PASSADA_UM / bilhetes quase nao
+  arredonde, e cada instrucao sempre avance a passada*/
+#define PASSADA_UM (1 << 20)
 
 typedef enum { bloqueado, pronto, morto } estado_proc;
+/*o que o processo bloqueado espera*/
+typedef enum { bloq_terminal, bloq_processo, bloq_dorme } motivo_bloqueio;
+
+#define FP_FORA -1 //fp_nivel de processo fora da fila de prontos
+#define SURTO_INICIAL 250 //previsao do primeiro surto de cpu, em instrucoes
+#define N_FAIXAS_ATRASO 5 //faixas do histograma de atrasos: 0, 1, 2-3, 4-7, 8+
+
+/*classe de tempo real (ver SO_TEMPO_REAL), tempos em interrupcoes do relogio;
+  a cada periodo eh liberado um job, que termina quando o processo bloqueia
+  ou esgota o orcamento*/
+typedef struct {
+    int periodo;        /*0 se o processo nao eh de tempo real*/
+    int orcamento;      /*cpu por periodo*/
+    int restante;       /*orcamento restante do job atual*/
+    int prazo;          /*fim do periodo do job atual*/
+    int liberacao;      /*quando pode ser liberado o proximo job*/
+    bool ativo;         /*tem job liberado e nao terminado*/
+    int n_jobs;
+    int n_perdas;       /*jobs que terminaram depois do prazo*/
+    int atraso_max;
+    int atrasos[N_FAIXAS_ATRASO];
+} tempo_real_t;
 
 struct processo_t{
     int id;
@@ -17,64 +45,101 @@ struct processo_t{
     err_t erro;
     int memIni;
     int memTam;
-    int t_cpu;
-    int n_exec;
+    int t_cpu;          /*instrucoes executadas no surto de cpu atual*/
+    int n_exec;         /*numero de surtos de cpu completos*/
     estado_proc estado;
+    motivo_bloqueio bloqueio; /*valido se estado == bloqueado*/
     float prio;
     int id_terminal;
     int espera_terminal;
     int quantum;
+    /*encadeamento na fila de prontos (ver fila_prontos.h)*/
+    struct processo_t* fp_prox;
+    struct processo_t* fp_ant;
+    int fp_nivel;
+    /*contabilidade da cpu, em instrucoes*/
+    int t_despacho;     /*relogio no ultimo despacho*/
+    int instrucoes;     /*total executado*/
+    long long vruntime; /*tempo virtual do escalonador justo (so cresce)*/
+    int t_entrada_pronto; /*relogio quando entrou na fila de prontos*/
+    int t_executavel;   /*total na fila de prontos (executando ou nao)*/
+    no_heap_t no_heap;  /*encadeamento no heap de prontos (justo e passada)*/
+    int nivel_mlfq;     /*nivel no escalonador mlfq (0 eh o mais alto)*/
+    int bilhetes;       /*fatia da cpu nos escalonadores loteria e passada*/
+    long long passada;  /*posicao no escalonador passada (so cresce)*/
+    int passo;          /*avanco da passada por instrucao, PASSADA_UM / bilhetes*/
+    int surto_previsto; /*previsao do proximo surto de cpu (sjf e srtf)*/
+    int erro_previsao;  /*soma dos erros absolutos das previsoes*/
+    int t_criacao;      /*relogio (em instrucoes) na criacao*/
+    tempo_real_t tr;
+    no_heap_t no_tempo_real;  /*encadeamento no heap de tempo real, por prazo*/
+    no_heap_t no_liberacao;   /*encadeamento no heap dos que esperam o proximo
+                                job, por liberacao*/
+    int grupo;          /*grupo de processos (ver SO_CRIA_PROC)*/
+    /*cota de cpu (ver SO_COTA)*/
+    int cota;           /*instrucoes por janela, 0 se nao tem cota*/
+    int usado_cota;     /*instrucoes executadas na janela atual*/
+    bool estrangulado;  /*esgotou a cota, fora dos prontos ate a proxima janela*/
+    no_lista_t no_cota; /*encadeamento na lista dos com cota ou estrangulados*/
+    int n_estrangulamentos;
+    /*encadeamentos em listas (ver lista.h); o processo muda de lista sem
+      alocar memoria*/
+    no_lista_t no_todos;   /*lista de todos os processos (ver tabela_proc.h)*/
+    no_lista_t no_espera;  /*fila de espera em que o processo esta bloqueado*/
+    lista_t* fila_espera;  /*essa fila, NULL se nao esta bloqueado*/
+    lista_t esperando_fim; /*processos em SO_ESPERA_PROC por este*/
+    no_roda_t no_dorme;    /*encadeamento na roda de tempo, em SO_DORME*/
 };
 typedef struct processo_t processo_t;
 
-struct lista_processos {
-    int id;
-    float prio;
-    estado_proc estado;
-    struct lista_processos* prox;
-};
-typedef struct lista_processos Lista_processos;
-
 #define TIPOS_ESTADOS 3
 
 struct historico_processos {
     int id;
     int tempo_vida;     /*tempo de criacao --> tempo_vida = agora - tempo_vida*/
+    int t_criacao;      /*relogio real na criacao*/
+    int t_morte;        /*relogio real na morte, -1 enquanto vivo*/
     int n_preempcoes;      /*Numero de vezes que foi escalonado*/
     int tempo_espera;       /*Tempo entre de espera entre desbloqueio e escalonamento - total para no final pegar media*/
     int quant_irq[TIPOS_IRQ];
     int tempo_desde_ult_estado;
     int tempo_estado[TIPOS_ESTADOS];
     int quant_estado[TIPOS_ESTADOS];
-    struct historico_processos* prox;
+    int instrucoes;     /*total executado, copiado do processo quando morre*/
+    int t_executavel;   /*total pronto ou executando, idem*/
+    int bilhetes;       /*idem*/
+    int n_surtos;       /*idem, n_exec*/
+    int erro_previsao;  /*idem*/
+    int retorno;        /*tempo de retorno, em instrucoes*/
+    tempo_real_t tr;    /*copiado do processo quando morre*/
+    int grupo;          /*grupo do processo*/
+    int cota;           /*copiado do processo quando morre*/
+    int n_estrangulamentos;  /*idem*/
 };
 typedef struct historico_processos Historico_processos;
 
+/*historicos de todos os processos ja criados, num vetor indexado pelo pid
+  (os pids sao dados em sequencia a partir de 0), para a busca ser O(1)
+  mesmo com muitos processos; o vetor dobra de tamanho quando enche*/
+typedef struct {
+    Historico_processos* v;
+    int n;              /*numero de historicos (pids de 0 a n-1)*/
+    int cap;
+} Historicos;
+
+#define HST_CAP_INICIAL 16
+
 
 //processo_t inicializa_init(processo_t processo);
-//processo_t *inicializa_processos(processo_t processos[MAX_PROCESSOS]);
 processo_t* inicializa_processo(processo_t* processo, int id, int PC, int tam);
-int entrada_livre_tabela_proc(processo_t processos[MAX_PROCESSOS]);
-int encontra_indice_processo(processo_t processos[MAX_PROCESSOS], int id);
-void altera_estado_proc_tabela(processo_t processos[MAX_PROCESSOS], int id, estado_proc estado);
+void inicializa_tempo_real(tempo_real_t* tr);
 char *estado_nome(estado_proc est);
 
-void lst_libera(Lista_processos* l);
-void lst_imprime (Lista_processos* l);
-Lista_processos* lst_altera_estado(Lista_processos* l, int id, estado_proc estado);
-Lista_processos* lst_insere_ordenado (Lista_processos* l, int id, float prio);
-Lista_processos* lst_adicionar_final(Lista_processos* l, int id, float prio);
-Lista_processos* lst_retira (Lista_processos* l, int id);
-Lista_processos* lst_busca(Lista_processos* l, int id);
-void lst_atualiza_prioridades(Lista_processos *l);
-
-Historico_processos* inicializa_historico_proc(int id, int tempo);
-void hst_libera(Historico_processos* h);
-void hst_imprime(Historico_processos* h);
-int hst_vazia(Historico_processos* h);
-Historico_processos* hst_insere_ordenado (Historico_processos* h, int id, int tempo);
-Historico_processos* hst_retira (Historico_processos* h, int id);
-Historico_processos* hst_busca(Historico_processos* h, int id);
-Historico_processos* hst_atualiza_preempcoes(Historico_processos* h, int id);
+void inicializa_historico_proc(Historico_processos* h, int id, int tempo);
+bool hst_inicializa(Historicos* hs);
+void hst_libera(Historicos* hs);
+bool hst_reserva(Historicos* hs, int n);
+Historico_processos* hst_insere(Historicos* hs, int id, int tempo);
+Historico_processos* hst_busca(Historicos* hs, int id);
 
 #endif
\ No newline at end of file
@@ -8,10 +8,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+// uma região não inicializada
+typedef struct {
+  int ini;
+  int tam;
+} bss_t;
+
 struct programa_t {
   int carga;
   int tamanho;
   int *dados;
+  int n_bss;
+  bss_t *bss;
 };
 
 // lê os dados do cabeçalho do arquivo (1ª linha)
@@ -29,9 +37,32 @@ static programa_t *pega_cabecalho(char *lin)
   }
   prog->tamanho = tam;
   prog->carga = carga;
+  prog->n_bss = 0;
+  prog->bss = NULL;
   return prog;
 }
 
+// lê uma linha com uma região BSS ("//BSS início tamanho")
+// as regiões fora do programa, fora de ordem ou sobrepostas são ignoradas
+static void pega_bss(programa_t *self, char *lin)
+{
+  int ini, tam;
+  if (sscanf(lin, "//BSS %d %d", &ini, &tam) != 2) return;
+  if (tam < 1 || ini < self->carga || ini + tam > self->carga + self->tamanho) {
+    return;
+  }
+  if (self->n_bss > 0) {
+    bss_t *ant = &self->bss[self->n_bss - 1];
+    if (ini < ant->ini + ant->tam) return;
+  }
+  bss_t *novo = realloc(self->bss, (self->n_bss + 1) * sizeof(*novo));
+  if (novo == NULL) return;
+  self->bss = novo;
+  self->bss[self->n_bss].ini = ini;
+  self->bss[self->n_bss].tam = tam;
+  self->n_bss++;
+}
+
 // lê os dados de uma linha
 // a linha tem o endereço inicial dos seus dados entre colchetes,
 // seguido dos dados, cada um seguido por vírgula
@@ -64,7 +95,11 @@ programa_t *prog_cria(char *nome)
   if (prog == NULL) goto fim;
 
   while (getline(&linha, &tam_lin, arq) != -1) {
-    pega_dados(prog, linha);
+    if (linha[0] == '/') {
+      pega_bss(prog, linha);
+    } else {
+      pega_dados(prog, linha);
+    }
   }
 
 fim:
@@ -76,6 +111,7 @@ fim:
 void prog_destroi(programa_t *self)
 {
   free(self->dados);
+  free(self->bss);
   free(self);
 }
 
@@ -99,3 +135,35 @@ int prog_dado(programa_t *self, int ender)
   if (ender < self->carga || ender >= self->carga + self->tamanho) return -1;
   return self->dados[ender - self->carga];
 }
+
+int *prog_dados(programa_t *self)
+{
+  return self->dados;
+}
+
+int prog_n_bss(programa_t *self)
+{
+  return self->n_bss;
+}
+
+void prog_bss(programa_t *self, int n, int *pini, int *ptam)
+{
+  *pini = self->bss[n].ini;
+  *ptam = self->bss[n].tam;
+}
+
+err_t prog_carrega(programa_t *self, mem_t *mem)
+{
+  // copia os dados entre as regiões BSS, e zera estas
+  int ini = self->carga;
+  for (int b = 0; b <= self->n_bss; b++) {
+    int fim = b < self->n_bss ? self->bss[b].ini : self->carga + self->tamanho;
+    err_t err = mem_copia(mem, ini, &self->dados[ini - self->carga], fim - ini);
+    if (err != ERR_OK) return err;
+    if (b == self->n_bss) break;
+    err = mem_preenche(mem, self->bss[b].ini, self->bss[b].tam, 0);
+    if (err != ERR_OK) return err;
+    ini = self->bss[b].ini + self->bss[b].tam;
+  }
+  return ERR_OK;
+}
@@ -7,6 +7,10 @@
 #define PROGRAMA_H
 
 // TAD para representar um programa lido de um arquivo '.maq'
+// O programa pode ter regiões não inicializadas (BSS), que não estão no
+//   arquivo e devem ser preenchidas com zero na carga.
+
+#include "memoria.h"
 
 typedef struct programa_t programa_t;
 
@@ -31,4 +35,21 @@ int prog_end_inicio(programa_t *self);
 // valor a colocar na posição 'ender' da memória
 int prog_dado(programa_t *self, int ender);
 
+// vetor com os prog_tamanho() valores a colocar na memória a partir do
+//   endereço de carga (para carregar o programa de uma vez só)
+// as regiões BSS estão zeradas
+int *prog_dados(programa_t *self);
+
+// número de regiões BSS do programa
+int prog_n_bss(programa_t *self);
+
+// endereço inicial e tamanho da região BSS 'n' (as regiões estão em ordem
+//   de endereço e não se sobrepõem)
+void prog_bss(programa_t *self, int n, int *pini, int *ptam);
+
+// coloca o programa na memória, copiando os dados e preenchendo as regiões
+//   BSS com zero
+// retorna o erro de acesso à memória, se houver
+err_t prog_carrega(programa_t *self, mem_t *mem);
+
 #endif // PROGRAMA_H
@@ -0,0 +1,73 @@
+// rastro.c
+// rastro dos acessos à memória
+// simulador de computador
+// so25b
+
+#include "rastro.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+// número de registros no buffer circular
+#define RASTRO_TAM_BUFFER 4096
+
+struct rastro_t {
+  FILE *arq;
+  int pid;
+  int n_registros;   // quantos registros estão no buffer
+  rastro_registro_t buffer[RASTRO_TAM_BUFFER];
+};
+
+// grava no arquivo os registros que estão no buffer e esvazia o buffer
+static void rastro_descarrega(rastro_t *self)
+{
+  if (self->n_registros == 0) return;
+  fwrite(self->buffer, sizeof(rastro_registro_t), self->n_registros, self->arq);
+  self->n_registros = 0;
+}
+
+rastro_t *rastro_cria(char *nome)
+{
+  FILE *arq = fopen(nome, "wb");
+  if (arq == NULL) return NULL;
+
+  rastro_t *self = malloc(sizeof(*self));
+  assert(self != NULL);
+
+  self->arq = arq;
+  self->pid = RASTRO_SEM_PID;
+  self->n_registros = 0;
+
+  rastro_cabecalho_t cab = { RASTRO_MAGICO, RASTRO_VERSAO };
+  fwrite(&cab, sizeof(cab), 1, self->arq);
+
+  return self;
+}
+
+void rastro_destroi(rastro_t *self)
+{
+  if (self == NULL) return;
+  rastro_descarrega(self);
+  fclose(self->arq);
+  free(self);
+}
+
+void rastro_define_pid(rastro_t *self, int pid)
+{
+  self->pid = pid;
+}
+
+void rastro_registra(rastro_t *self, int endereco, rastro_acesso_t tipo,
+                     int modo)
+{
+  rastro_registro_t *r = &self->buffer[self->n_registros];
+  r->endereco = endereco;
+  r->pid = self->pid;
+  r->tipo = tipo;
+  r->modo = modo;
+  self->n_registros++;
+  if (self->n_registros == RASTRO_TAM_BUFFER) {
+    rastro_descarrega(self);
+  }
+}
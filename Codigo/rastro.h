@@ -0,0 +1,66 @@
+// rastro.h
+// rastro dos acessos à memória
+// simulador de computador
+// so25b
+
+#ifndef RASTRO_H
+#define RASTRO_H
+
+// O rastro registra cada acesso da CPU à memória: o endereço, o tipo do
+//   acesso (busca de instrução, leitura ou escrita), o modo da CPU e o pid
+//   do processo corrente (informado pelo SO).
+// Os registros são colocados em um buffer circular em memória, que é
+//   descarregado no arquivo do rastro cada vez que enche (e na destruição
+//   do rastro). O custo por acesso é só o de preencher um registro.
+// O arquivo gerado é binário: um cabeçalho (rastro_cabecalho_t) seguido
+//   de registros (rastro_registro_t), na ordem em que os acessos foram
+//   realizados. O programa analisa_rastro lê esse arquivo.
+
+#include <stdint.h>
+
+typedef struct rastro_t rastro_t;
+
+// os tipos de acesso à memória
+typedef enum {
+  RASTRO_BUSCA,      // busca de instrução (opcode ou argumento)
+  RASTRO_LEITURA,    // leitura de dado
+  RASTRO_ESCRITA,    // escrita de dado
+  N_RASTRO_ACESSO
+} rastro_acesso_t;
+
+// pid usado quando não tem processo corrente
+#define RASTRO_SEM_PID -1
+
+// identificação do arquivo de rastro
+#define RASTRO_MAGICO 0x52545352  // "RSTR"
+#define RASTRO_VERSAO 2
+
+typedef struct {
+  uint32_t magico;
+  uint32_t versao;
+} rastro_cabecalho_t;
+
+// um registro de acesso no arquivo (12 bytes); o pid tem 32 bits porque os
+//   pids só são limitados pela tabela de processos
+typedef struct {
+  int32_t endereco;
+  int32_t pid;
+  uint8_t tipo;      // rastro_acesso_t
+  uint8_t modo;      // cpu_modo_t
+} rastro_registro_t;
+
+// cria um rastro que será gravado no arquivo 'nome'
+// retorna NULL se não conseguir criar o arquivo
+rastro_t *rastro_cria(char *nome);
+
+// descarrega o que tiver no buffer, fecha o arquivo e libera o rastro
+void rastro_destroi(rastro_t *self);
+
+// define o pid a associar aos próximos acessos
+void rastro_define_pid(rastro_t *self, int pid);
+
+// registra um acesso ao endereço 'endereco', feito com a CPU no modo 'modo'
+void rastro_registra(rastro_t *self, int endereco, rastro_acesso_t tipo,
+                     int modo);
+
+#endif // RASTRO_H
@@ -86,3 +86,17 @@ err_t relogio_escrita(void *disp, int id, int pvalor)
   }
   return err;
 }
+
+void *relogio_salva(void *self)
+{
+  relogio_t *copia = malloc(sizeof(*copia));
+  assert(copia != NULL);
+  *copia = *(relogio_t *)self;
+  return copia;
+}
+
+bool relogio_restaura(void *self, void *estado)
+{
+  *(relogio_t *)self = *(relogio_t *)estado;
+  return true;
+}
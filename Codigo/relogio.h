@@ -23,6 +23,8 @@
 
 #include "err.h"
 
+#include <stdbool.h>
+
 typedef struct relogio_t relogio_t;
 
 // cria e inicializa um relógio
@@ -45,4 +47,9 @@ void relogio_tictac(relogio_t *self);
 err_t relogio_leitura(void *disp, int id, int *pvalor);
 err_t relogio_escrita(void *disp, int id, int pvalor);
 
+// funções para salvar e recuperar o estado do relógio em um instantâneo
+//   (seguem o protocolo f_salva_t e f_restaura_t de instantaneo.h)
+void *relogio_salva(void *self);
+bool relogio_restaura(void *self, void *estado);
+
 #endif // RELOGIO_H
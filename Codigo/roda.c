@@ -0,0 +1,119 @@
+// roda.c
+// roda de tempo hierárquica
+// simulador de computador
+// so25b
+
+#include "roda.h"
+
+#define MASCARA (RODA_POSICOES - 1)
+// distância máxima de vencimento alcançada pelo último nível
+#define ALCANCE (1 << (RODA_BITS * RODA_NIVEIS))
+
+void roda_inicializa(roda_t *self, int agora)
+{
+  self->agora = agora;
+  self->n = 0;
+  for (int nivel = 0; nivel < RODA_NIVEIS; nivel++) {
+    for (int pos = 0; pos < RODA_POSICOES; pos++) {
+      lista_inicializa(&self->posicao[nivel][pos]);
+    }
+  }
+}
+
+void roda_inicializa_no(no_roda_t *no)
+{
+  lista_inicializa_no(&no->no);
+  no->lista = NULL;
+  no->expira = 0;
+}
+
+// coloca o nó na posição do nível mais baixo que alcança o seu vencimento
+static void coloca(roda_t *self, no_roda_t *no)
+{
+  int delta = no->expira - self->agora;
+  int expira = no->expira;
+  if (delta >= ALCANCE) expira = self->agora + ALCANCE - 1;
+  int nivel = 0;
+  while (nivel < RODA_NIVEIS - 1 && delta >= 1 << (RODA_BITS * (nivel + 1))) {
+    nivel++;
+  }
+  no->lista = &self->posicao[nivel][(expira >> (RODA_BITS * nivel)) & MASCARA];
+  lista_insere(no->lista, &no->no);
+}
+
+void roda_insere(roda_t *self, no_roda_t *no, int expira)
+{
+  if (no->lista != NULL) return;
+  if (expira <= self->agora) expira = self->agora + 1;
+  no->expira = expira;
+  coloca(self, no);
+  self->n++;
+}
+
+void roda_retira(roda_t *self, no_roda_t *no)
+{
+  if (no->lista == NULL) return;
+  lista_retira(no->lista, &no->no);
+  no->lista = NULL;
+  self->n--;
+}
+
+// avança a roda um instante; quando um nível dá a volta, os nós da posição
+//   atual do nível de cima descem
+static void avanca(roda_t *self)
+{
+  self->agora++;
+  for (int nivel = 1; nivel < RODA_NIVEIS; nivel++) {
+    if (((self->agora >> (RODA_BITS * (nivel - 1))) & MASCARA) != 0) break;
+    lista_t *lista = &self->posicao[nivel][(self->agora >> (RODA_BITS * nivel)) & MASCARA];
+    no_lista_t *no;
+    while ((no = lista_primeiro(lista)) != NULL) {
+      lista_retira(lista, no);
+      coloca(self, LISTA_DONO(no, no_roda_t, no));
+    }
+  }
+}
+
+no_roda_t *roda_vence(roda_t *self, int alvo)
+{
+  for (;;) {
+    // a posição do instante atual no nível 0 só tem nós vencidos
+    no_lista_t *no = lista_primeiro(&self->posicao[0][self->agora & MASCARA]);
+    if (no != NULL) {
+      no_roda_t *vencido = LISTA_DONO(no, no_roda_t, no);
+      roda_retira(self, vencido);
+      return vencido;
+    }
+    if (self->agora >= alvo) return NULL;
+    // com a roda vazia, não tem o que descer
+    if (self->n == 0) {
+      self->agora = alvo;
+      return NULL;
+    }
+    avanca(self);
+  }
+}
+
+int roda_proximo(roda_t *self)
+{
+  if (self->n == 0) return -1;
+  if (lista_n(&self->posicao[0][self->agora & MASCARA]) > 0) return self->agora;
+  // em cada nível, o início da primeira posição ocupada depois da atual
+  int proximo = -1;
+  for (int nivel = 0; nivel < RODA_NIVEIS; nivel++) {
+    int bits = RODA_BITS * nivel;
+    for (int i = 1; i <= RODA_POSICOES; i++) {
+      int pos = (self->agora >> bits) + i;
+      if (lista_n(&self->posicao[nivel][pos & MASCARA]) > 0) {
+        if (proximo == -1 || pos << bits < proximo) proximo = pos << bits;
+        break;
+      }
+    }
+  }
+  return proximo;
+}
+
+int roda_n(roda_t *self)
+{
+  return self->n;
+}
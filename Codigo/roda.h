@@ -0,0 +1,67 @@
+// roda.h
+// roda de tempo hierárquica
+// simulador de computador
+// so25b
+
+#ifndef RODA_H
+#define RODA_H
+
+// Guarda nós com um instante de vencimento, para retirá-los em ordem de
+//   vencimento conforme o tempo avança; inserir e retirar são O(1), e avançar
+//   a roda é O(1) por unidade de tempo (amortizado).
+// A roda tem RODA_NIVEIS níveis de RODA_POSICOES posições, e cada posição é
+//   uma lista (ver lista.h). No nível 0, cada posição é uma unidade de tempo;
+//   no nível n, cada posição corresponde a RODA_POSICOES^n unidades. Um nó fica
+//   no nível mais baixo que alcança o seu vencimento, e desce (cascata) quando
+//   o nível de baixo dá uma volta. Vencimentos além do último nível são
+//   colocados na última posição alcançável, e recolocados quando ela desce.
+// Os nós ficam dentro das estruturas que estão na roda (por exemplo, no
+//   descritor do processo), como os da lista.
+// Os nós apontam para as listas da roda, então a roda só pode ser copiada
+//   (num instantâneo, por exemplo) se voltar para o mesmo lugar.
+
+#include "lista.h"
+
+#define RODA_BITS      6
+#define RODA_POSICOES  (1 << RODA_BITS)
+#define RODA_NIVEIS    4
+
+typedef struct {
+  no_lista_t no;
+  lista_t *lista;    // posição da roda em que o nó está, NULL se fora
+  int expira;        // instante de vencimento
+} no_roda_t;
+
+typedef struct {
+  int agora;         // último instante já vencido
+  int n;             // número de nós na roda
+  lista_t posicao[RODA_NIVEIS][RODA_POSICOES];
+} roda_t;
+
+// inicializa uma roda vazia, no instante 'agora'
+void roda_inicializa(roda_t *self, int agora);
+
+// inicializa um nó, que fica fora da roda
+void roda_inicializa_no(no_roda_t *no);
+
+// insere o nó na roda, para vencer no instante 'expira' (se for antes do
+//   próximo instante da roda, vence no próximo)
+// se o nó já estiver na roda, não faz nada
+void roda_insere(roda_t *self, no_roda_t *no, int expira);
+
+// retira o nó da roda (se não estiver, não faz nada)
+void roda_retira(roda_t *self, no_roda_t *no);
+
+// avança a roda até no máximo o instante 'alvo', e retira e retorna o
+//   primeiro nó vencido; retorna NULL se não houver nó vencido até 'alvo'
+// para obter todos os vencidos, chame até retornar NULL
+no_roda_t *roda_vence(roda_t *self, int alvo);
+
+// retorna um instante não posterior ao vencimento mais próximo, ou -1 se a
+//   roda estiver vazia (o instante é exato se o vencimento estiver no nível 0)
+int roda_proximo(roda_t *self);
+
+// retorna o número de nós na roda
+int roda_n(roda_t *self);
+
+#endif // RODA_H
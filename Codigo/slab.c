@@ -0,0 +1,173 @@
+// slab.c
+// alocador de objetos de tamanho fixo, em blocos
+// simulador de computador
+// so25b
+
+#include "slab.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+// cada objeto é precedido por um cabeçalho, com o seu índice; o tamanho do
+//   cabeçalho e do passo entre objetos mantém o alinhamento do objeto
+typedef struct {
+  int indice;
+  bool alocado;
+} cabecalho_t;
+
+#define ALINHAMENTO (sizeof(max_align_t))
+#define ARREDONDA(n) (((n) + ALINHAMENTO - 1) / ALINHAMENTO * ALINHAMENTO)
+#define TAM_CABECALHO ARREDONDA(sizeof(cabecalho_t))
+
+struct slab_t {
+  int passo;           // bytes entre o início de dois objetos
+  char **blocos;
+  int n_blocos;
+  int *livres;         // pilha com os índices dos objetos livres
+  int n_livres;
+  int n;               // objetos alocados
+};
+
+slab_t *slab_cria(int tam_obj)
+{
+  slab_t *self = malloc(sizeof(*self));
+  if (self == NULL) return NULL;
+  self->passo = TAM_CABECALHO + ARREDONDA(tam_obj);
+  self->blocos = NULL;
+  self->n_blocos = 0;
+  self->livres = NULL;
+  self->n_livres = 0;
+  self->n = 0;
+  return self;
+}
+
+void slab_destroi(slab_t *self)
+{
+  for (int b = 0; b < self->n_blocos; b++) {
+    free(self->blocos[b]);
+  }
+  free(self->blocos);
+  free(self->livres);
+  free(self);
+}
+
+static cabecalho_t *cabecalho(slab_t *self, int i)
+{
+  return (cabecalho_t *)(self->blocos[i / SLAB_OBJS_BLOCO]
+                         + (i % SLAB_OBJS_BLOCO) * self->passo);
+}
+
+// acrescenta um bloco, com todos os objetos livres
+static bool novo_bloco(slab_t *self)
+{
+  int n = self->n_blocos + 1;
+  char **blocos = realloc(self->blocos, n * sizeof(*blocos));
+  if (blocos == NULL) return false;
+  self->blocos = blocos;
+  int *livres = realloc(self->livres, n * SLAB_OBJS_BLOCO * sizeof(*livres));
+  if (livres == NULL) return false;
+  self->livres = livres;
+  char *bloco = malloc(SLAB_OBJS_BLOCO * self->passo);
+  if (bloco == NULL) return false;
+  self->blocos[self->n_blocos++] = bloco;
+  // empilha ao contrário, para os de menor índice saírem primeiro
+  for (int j = SLAB_OBJS_BLOCO - 1; j >= 0; j--) {
+    int i = (n - 1) * SLAB_OBJS_BLOCO + j;
+    cabecalho_t *c = cabecalho(self, i);
+    c->indice = i;
+    c->alocado = false;
+    self->livres[self->n_livres++] = i;
+  }
+  return true;
+}
+
+void *slab_aloca(slab_t *self)
+{
+  if (self->n_livres == 0 && !novo_bloco(self)) return NULL;
+  cabecalho_t *c = cabecalho(self, self->livres[--self->n_livres]);
+  c->alocado = true;
+  self->n++;
+  return (char *)c + TAM_CABECALHO;
+}
+
+void slab_libera(slab_t *self, void *obj)
+{
+  cabecalho_t *c = (cabecalho_t *)((char *)obj - TAM_CABECALHO);
+  if (!c->alocado) return;
+  c->alocado = false;
+  self->livres[self->n_livres++] = c->indice;
+  self->n--;
+}
+
+int slab_n(slab_t *self)
+{
+  return self->n;
+}
+
+int slab_capacidade(slab_t *self)
+{
+  return self->n_blocos * SLAB_OBJS_BLOCO;
+}
+
+void *slab_obj(slab_t *self, int i)
+{
+  cabecalho_t *c = cabecalho(self, i);
+  return c->alocado ? (char *)c + TAM_CABECALHO : NULL;
+}
+
+
+// ---------------------------------------------------------------------
+// INSTANTÂNEOS {{{1
+// ---------------------------------------------------------------------
+
+// o estado é o número de blocos, a pilha de livres e o conteúdo dos blocos
+// como os blocos nunca são liberados, na recuperação o alocador tem pelo
+//   menos tantos blocos quanto no salvamento; os blocos a mais ficam livres
+
+typedef struct {
+  int n_blocos;
+  int n_livres;
+  int n;
+} slab_estado_t;
+
+int slab_tam_estado(slab_t *self)
+{
+  return sizeof(slab_estado_t) + self->n_livres * sizeof(int)
+         + self->n_blocos * SLAB_OBJS_BLOCO * self->passo;
+}
+
+void slab_salva(slab_t *self, void *estado)
+{
+  slab_estado_t *e = estado;
+  e->n_blocos = self->n_blocos;
+  e->n_livres = self->n_livres;
+  e->n = self->n;
+  char *p = (char *)(e + 1);
+  memcpy(p, self->livres, self->n_livres * sizeof(int));
+  p += self->n_livres * sizeof(int);
+  for (int b = 0; b < self->n_blocos; b++) {
+    memcpy(p, self->blocos[b], SLAB_OBJS_BLOCO * self->passo);
+    p += SLAB_OBJS_BLOCO * self->passo;
+  }
+}
+
+void slab_restaura(slab_t *self, void *estado)
+{
+  slab_estado_t *e = estado;
+  char *p = (char *)(e + 1);
+  memcpy(self->livres, p, e->n_livres * sizeof(int));
+  self->n_livres = e->n_livres;
+  self->n = e->n;
+  p += e->n_livres * sizeof(int);
+  for (int b = 0; b < e->n_blocos; b++) {
+    memcpy(self->blocos[b], p, SLAB_OBJS_BLOCO * self->passo);
+    p += SLAB_OBJS_BLOCO * self->passo;
+  }
+  for (int i = slab_capacidade(self) - 1; i >= e->n_blocos * SLAB_OBJS_BLOCO; i--) {
+    cabecalho(self, i)->alocado = false;
+    self->livres[self->n_livres++] = i;
+  }
+}
+
+// vim: foldmethod=marker
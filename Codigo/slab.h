@@ -0,0 +1,53 @@
+// slab.h
+// alocador de objetos de tamanho fixo, em blocos
+// simulador de computador
+// so25b
+
+#ifndef SLAB_H
+#define SLAB_H
+
+// Os objetos são alocados em blocos de SLAB_OBJS_BLOCO objetos; quando não
+//   há objeto livre, é alocado mais um bloco. Os objetos livres ficam numa
+//   pilha, e alocar e liberar são O(1).
+// Os blocos não são realocados nem liberados (a não ser em slab_destroi),
+//   então um objeto nunca muda de endereço, e pode conter encadeamentos
+//   intrusivos (ver fila_prontos.h e heap.h).
+// Cada objeto tem um índice, entre 0 e slab_capacidade()-1, que não muda.
+
+#include <stdbool.h>
+
+#define SLAB_OBJS_BLOCO 64
+
+typedef struct slab_t slab_t;
+
+// cria um alocador de objetos com 'tam_obj' bytes
+slab_t *slab_cria(int tam_obj);
+
+// destrói o alocador e todos os objetos
+void slab_destroi(slab_t *self);
+
+// aloca um objeto (não inicializado); retorna NULL se faltar memória
+void *slab_aloca(slab_t *self);
+
+// libera um objeto alocado com slab_aloca
+void slab_libera(slab_t *self, void *obj);
+
+// número de objetos alocados
+int slab_n(slab_t *self);
+
+// número de objetos nos blocos (alocados ou livres)
+int slab_capacidade(slab_t *self);
+
+// retorna o objeto de índice 'i', ou NULL se ele estiver livre
+void *slab_obj(slab_t *self, int i);
+
+// funções para salvar e recuperar o conteúdo de todos os objetos
+//   (e quais estão alocados) em um instantâneo; o estado é salvo em 'estado',
+//   que deve ter slab_tam_estado() bytes
+// na recuperação os objetos voltam aos mesmos endereços, então ponteiros
+//   para eles continuam válidos
+int slab_tam_estado(slab_t *self);
+void slab_salva(slab_t *self, void *estado);
+void slab_restaura(slab_t *self, void *estado);
+
+#endif // SLAB_H
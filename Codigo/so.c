@@ -15,9 +15,14 @@
 #include "programa.h"
 #include "cpu.h"
 #include "processo.h"
+#include "tabela_proc.h"
+#include "escalonador.h"
+#include "adiado.h"
+#include "roda.h"
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
 
 // ---------------------------------------------------------------------
@@ -26,7 +31,27 @@
 
 // intervalo entre interrupções do relógio
 #define INTERVALO_INTERRUPCAO 50   // em instruções executadas
+// com true, o relógio só é programado quando o SO precisa de interrupções
+//   dele (ver so_programa_relogio); com false, interrompe periodicamente
+#define RELOGIO_SOB_DEMANDA true
 #define TERMINAIS 4
+/*trabalho adiado (ver adiado.h): o tratamento de cada IRQ so confirma o
+  dispositivo e agenda o trabalho, que e feito em so_executa_adiado. Os
+  tipos, em ordem de prioridade (a prioridade de cada um e o proprio tipo)*/
+#define ADIADO_TIQUE 0        /*tique do relogio para o escalonador*/
+#define ADIADO_TECLADO 1      /*dado: terminais (1<<t) com teclado a atender*/
+#define ADIADO_TELA 2         /*dado: terminais (1<<t) com tela a atender*/
+#define ADIADO_OPERADOR 3     /*ver os pedidos do operador na console*/
+/*o trabalho com prioridade ate PRIO_URGENTE (so o tique) e feito antes de
+  escalonar; ate PRIO_ES (as filas dos terminais), antes de voltar para o
+  processo; o resto, quando a cpu vai ficar ociosa ou depois de esperar
+  ESPERA_ADIADO instrucoes*/
+#define PRIO_URGENTE ADIADO_TIQUE
+#define PRIO_ES ADIADO_TELA
+#define PRIO_QUALQUER ADIADO_TIPOS
+#define ESPERA_ADIADO 500
+// escalonador usado a partir da inicialização (ver escalonador.h)
+#define ESCALONADOR_INICIAL "simples"
 
 struct so_t {
   cpu_t *cpu;
@@ -37,19 +62,29 @@ struct so_t {
 
   int regA, regX, regPC, regERRO; // cópia do estado da CPU
   // t2: tabela de processos, processo corrente, pendências, etc
-  processo_t processos[MAX_PROCESSOS];
+  tabela_proc_t *tabela;
   processo_t *processo_corrente;
-  Lista_processos* ini_fila_proc;
-  Lista_processos* ini_fila_proc_prontos;
+  /*filas de espera dos processos bloqueados em E/S, por terminal; quem
+    espera o fim de um processo fica na fila do descritor dele*/
+  lista_t espera_teclado[TERMINAIS];
+  lista_t espera_tela[TERMINAIS];
+  escalonador_t esc;
   int cont_processos; 
   bool dispositivos_livres[TERMINAIS]; 
-  Historico_processos* ini_hist_proc;
+  /*as filas de espera do teclado/tela so sao vistas quando algum terminal
+    interrompe ou e liberado, com trabalho adiado*/
+  adiado_t adiado;
+  /*processos em SO_DORME, na roda de tempo (ver roda.h), por instante de
+    acordar em intervalos do relogio*/
+  roda_t roda;
+  Historicos hist;      /*historico de cada processo, indexado pelo pid*/
+  int agora_real;       /*relogio real, lido uma vez por interrupcao*/
   int tempo_total_execucao;
   int tempo_ocioso_total;
   int momento_sist_ocioso;   /*Tempo que o sistema atualmente esta ocioso, antes de somar no total*/
   int n_preempcoes;      /*Numero total de vencimentos do quantum*/
   int quant_irq[TIPOS_IRQ+1];   /*Considerando a Interrupção Desconhecida*/
-  escalonador_atual escalonador;
+  rastro_t *rastro;
 };
 
 // função de tratamento de interrupção (entrada no SO)
@@ -78,25 +113,31 @@ so_t *so_cria(cpu_t *cpu, mem_t *mem, es_t *es, console_t *console)
   self->erro_interno = false;
 
   self->cont_processos = 0;
-  self->ini_fila_proc = NULL;
   self->processo_corrente = NULL;
-  self->ini_hist_proc = NULL;
-  self->ini_fila_proc_prontos = NULL;
-  for(int i = 0; i < MAX_PROCESSOS; i++){
-    self->processos[i].estado = morto;
+  self->tabela = tp_cria();
+  if (self->tabela == NULL || !hst_inicializa(&self->hist)) {
+    if (self->tabela != NULL) tp_destroi(self->tabela);
+    free(self);
+    return NULL;
   }
+  esc_inicializa(&self->esc, self->tabela, ESCALONADOR_INICIAL);
 
+  adiado_inicializa(&self->adiado);
+  roda_inicializa(&self->roda, 0);
   for(int i = 0; i < TERMINAIS; i++){
     self->dispositivos_livres[i] = true;
+    lista_inicializa(&self->espera_teclado[i]);
+    lista_inicializa(&self->espera_tela[i]);
   }
   es_le(self->es, D_RELOGIO_REAL, &self->tempo_total_execucao);   /*tempo inicial do relogio*/
+  self->agora_real = self->tempo_total_execucao;
   self->tempo_ocioso_total = 0;
   self->momento_sist_ocioso = 0;
   self->n_preempcoes = 0;
   for(int i = 0; i < TIPOS_IRQ+1; i++){
     self->quant_irq[i] = 0;
   }
-  self->escalonador = simples;
+  self->rastro = NULL;
 
   // quando a CPU executar uma instrução CHAMAC, deve chamar a função
   //   so_trata_interrupcao, com primeiro argumento um ptr para o SO
@@ -108,19 +149,111 @@ so_t *so_cria(cpu_t *cpu, mem_t *mem, es_t *es, console_t *console)
 void so_destroi(so_t *self)
 {
   cpu_define_chamaC(self->cpu, NULL, NULL);
+  esc_finaliza(&self->esc);
+  tp_destroi(self->tabela);
+  hst_libera(&self->hist);
   free(self);
 }
 
+void so_define_rastro(so_t *self, rastro_t *rastro)
+{
+  self->rastro = rastro;
+}
+
+bool so_define_escalonador(so_t *self, char *nome)
+{
+  const esc_ops_t *ops = esc_busca(nome);
+  if (ops == NULL) {
+    console_printf("SO: escalonador '%s' nao existe", nome);
+    esc_lista();
+    return false;
+  }
+  esc_muda_politica(&self->esc, ops);
+  console_printf("SO: escalonador %s", esc_nome(&self->esc));
+  return true;
+}
+
+
+// ---------------------------------------------------------------------
+// INSTANTÂNEOS {{{1
+// ---------------------------------------------------------------------
+
+// o estado salvo é a estrutura do SO seguida do vetor de históricos e dos
+//   estados da tabela de processos e do escalonador
+// na recuperação, o vetor de históricos atual é reaproveitado (ele pode ter
+//   sido realocado depois do salvamento); os ponteiros para os descritores (o processo corrente e os
+//   encadeamentos das listas e do escalonador) continuam válidos porque os
+//   descritores voltam aos mesmos endereços (ver tabela_proc.h)
+typedef struct {
+  so_t so;
+  int tam_tabela;
+  int tam_esc;
+} so_estado_t;
+
+void *so_salva(void *so)
+{
+  so_t *self = so;
+  int n_hist = self->hist.n;
+  int tam_tabela = tp_tam_estado(self->tabela);
+  int tam_esc = esc_tam_estado(&self->esc);
+
+  so_estado_t *estado = malloc(sizeof(*estado)
+                               + n_hist * sizeof(Historico_processos)
+                               + tam_tabela + tam_esc);
+  if (estado == NULL) return NULL;
+  estado->so = *self;
+  estado->tam_tabela = tam_tabela;
+  estado->tam_esc = tam_esc;
+
+  Historico_processos *hs = (Historico_processos *)(estado + 1);
+  memcpy(hs, self->hist.v, n_hist * sizeof(Historico_processos));
+  char *p = (char *)(hs + n_hist);
+  tp_salva(self->tabela, p);
+  esc_salva(&self->esc, p + tam_tabela);
+  return estado;
+}
+
+// o que pode falhar (por falta de memória) é feito antes de alterar o SO; o
+//   histórico só cresce, e os mapas da tabela e do escalonador não encolhem
+//   (ver mapa_restaura), então com instantâneos deste SO eles não falham
+//   depois de um dos dois já ter sido recuperado
+bool so_restaura(void *so, void *est)
+{
+  so_t *self = so;
+  so_estado_t *estado = est;
+  int n_hist = estado->so.hist.n;
+  Historico_processos *hs = (Historico_processos *)(estado + 1);
+  char *p = (char *)(hs + n_hist);
+
+  if (!hst_reserva(&self->hist, n_hist)
+      || !tp_restaura(self->tabela, p)
+      || !esc_restaura(&self->esc, p + estado->tam_tabela)) {
+    console_printf("SO: sem memoria para recuperar o instantaneo");
+    return false;
+  }
+
+  Historicos hist = self->hist;
+  *self = estado->so;
+  self->hist = hist;
+  memcpy(self->hist.v, hs, n_hist * sizeof(Historico_processos));
+  self->hist.n = n_hist;
+  return true;
+}
+
 
 // ---------------------------------------------------------------------
 // TRATAMENTO DE INTERRUPÇÃO {{{1
 // ---------------------------------------------------------------------
 
 // funções auxiliares para o tratamento de interrupção
+static bool so_chamada_rapida(so_t *self);
 static void so_salva_estado_da_cpu(so_t *self);
+static void so_contabiliza_execucao(so_t *self);
 static void so_trata_irq(so_t *self, int irq);
 static void so_trata_pendencias(so_t *self);
+static bool so_executa_adiado(so_t *self, int prio_max);
 static void so_escalona(so_t *self);
+static void so_programa_relogio(so_t *self);
 static int so_despacha(so_t *self);
 
 // função a ser chamada pela CPU quando executa a instrução CHAMAC, no tratador de
@@ -143,14 +276,32 @@ static int so_trata_interrupcao(void *argC, int reg_A)
   irq_t irq = reg_A;
   // esse print polui bastante, recomendo tirar quando estiver com mais confiança
   console_printf("SO: recebi IRQ %d (%s)", irq, irq_nome(irq));
+  // as chamadas de sistema que terminam na hora, sem nada pendente, voltam
+  //   direto para o processo
+  if (irq == IRQ_SISTEMA && so_chamada_rapida(self)) return 0;
   // salva o estado da cpu no descritor do processo que foi interrompido
   so_salva_estado_da_cpu(self);
+  // contabiliza as instruções executadas pelo processo interrompido
+  so_contabiliza_execucao(self);
   // faz o atendimento da interrupção
   so_trata_irq(self, irq);
-  // faz o processamento independente da interrupção
+  // faz o processamento independente da interrupção e o trabalho adiado
+  //   urgente
   so_trata_pendencias(self);
   // escolhe o próximo processo a executar
   so_escalona(self);
+  // antes de voltar para o processo, faz o trabalho adiado de E/S; se a CPU
+  //   vai ficar ociosa, faz todo o resto; escolhe de novo se alguém acordou
+  int prio_max = PRIO_ES;
+  if (self->processo_corrente == NULL) {
+    adiado_agenda(&self->adiado, ADIADO_OPERADOR, ADIADO_OPERADOR, 0, self->esc.agora);
+    prio_max = PRIO_QUALQUER;
+  }
+  if (so_executa_adiado(self, prio_max)) {
+    so_escalona(self);
+  }
+  // programa a próxima interrupção do relógio, se for o caso
+  so_programa_relogio(self);
   // recupera o estado do processo escolhido
   return so_despacha(self);
 }
@@ -159,15 +310,14 @@ static void so_salva_estado_da_cpu(so_t *self)    /*Feito*/
 {
   // t2: salva os registradores que compõem o estado da cpu no descritor do
   //   processo corrente. os valores dos registradores foram colocados pela
-  //   CPU na memória, nos endereços CPU_END_PC etc. O registrador X foi salvo
-  //   pelo tratador de interrupção (ver trata_irq.asm) no endereço 59
+  //   CPU na memória, nos endereços CPU_END_PC etc
   // se não houver processo corrente, não faz nada
 
   if(self->processo_corrente != NULL && self->processo_corrente->estado != morto){
     if (mem_le(self->mem, CPU_END_A, &self->processo_corrente->A) != ERR_OK
         || mem_le(self->mem, CPU_END_PC, &self->processo_corrente->PC) != ERR_OK
         || mem_le(self->mem, CPU_END_erro, &self->processo_corrente->regErro) != ERR_OK
-        || mem_le(self->mem, 59, &self->processo_corrente->X) != ERR_OK) {
+        || mem_le(self->mem, CPU_END_X, &self->processo_corrente->X) != ERR_OK) {
       console_printf("SO: erro na leitura dos registradores");
       self->erro_interno = true;
     }
@@ -175,9 +325,13 @@ static void so_salva_estado_da_cpu(so_t *self)    /*Feito*/
 }
 
 /*Funções chamadas por so_trata_pendencias*/
-processo_t* so_proximo_pendente(so_t* self, int quant_bloq);
-Lista_processos* so_coloca_fila_pronto(so_t* self, processo_t* processo);
 static void so_muda_estado_processo(so_t* self, int id_proc, estado_proc est);
+static void so_bloqueia_processo(so_t* self, processo_t* processo, lista_t* fila, motivo_bloqueio motivo);
+static void so_libera_espera_proc(so_t *self, processo_t* morrendo);
+static void so_atende_teclado(so_t* self, int terminal);
+static void so_atende_tela(so_t* self, int terminal);
+static void so_libera_terminal(so_t* self, int terminal);
+static void so_acorda_dorminhocos(so_t* self);
 
 static void so_trata_pendencias(so_t *self)
 {
@@ -189,97 +343,66 @@ static void so_trata_pendencias(so_t *self)
   // - etc
   /*se esta usando terminal ou nao alocou/precisa terminal*/
   if(self->processo_corrente != NULL && (self->processo_corrente->estado == bloqueado || self->processo_corrente->espera_terminal == 0))
-      self->dispositivos_livres[self->processo_corrente->id_terminal/4] = true;
-  /*E/S pendente*/
-  processo_t* processo_pendente = NULL;
-  int quant_proc_bloqueado = 0;
-  while((processo_pendente = so_proximo_pendente(self, quant_proc_bloqueado)) != NULL){   /*Enquanto tiver processos pendentes*/
-    /*if (processo_pendente->id != self->processo_corrente->id)*/
-    quant_proc_bloqueado++;
-    console_printf("(depois while processo pendente)");
-    int dado, estado_term;
-    if(processo_pendente->espera_terminal == 1){ 
-      console_printf("verifica espera_terminal=1");
-      if((es_le(self->es, processo_pendente->id_terminal + TERM_TECLADO_OK, &estado_term)) == ERR_OK){
-        if(estado_term == 0 && self->dispositivos_livres[processo_pendente->id_terminal / 4]){
-          if ((es_le(self->es, self->processo_corrente->id_terminal + TERM_TECLADO, &dado)) != ERR_OK)
-            console_printf("SO: problema no acesso ao teclado");
-          else{
-            self->processo_corrente->A = dado;
-            so_muda_estado_processo(self, processo_pendente->id, pronto);
-          }
-        }
-      }
-      else{
-        console_printf("SO: teclado nao disponivel"); 
-      }
-    }
-    else if(processo_pendente->espera_terminal == 2){
-      console_printf("verifica espera_terminal=2");
-      if((es_le(self->es, processo_pendente->id_terminal + TERM_TELA_OK, &estado_term)) == ERR_OK){
-        if(estado_term == 0 && self->dispositivos_livres[processo_pendente->id_terminal / 4]){
-          dado = self->processo_corrente->X;
-          if ((es_escreve(self->es,  self->processo_corrente->id_terminal + TERM_TELA, dado)) != ERR_OK)
-            console_printf("SO: problema no acesso à tela");
-          else{
-            self->processo_corrente->A = 0;
-            so_muda_estado_processo(self, processo_pendente->id, pronto);
-          }
-        }
-        console_printf("process_pend estado_term %d", estado_term);
-      }
-      else{
-        console_printf("SO: tela nao disponivel"); /*retirar depois - depuracao*/
-      }
-    }
-    /*else{   //espera_terminal = 0, pode ser por esperar outro processo acabar
-      //Desbloqueio de processos bloqueados por espera
-      so_chamada_espera_proc(self, processo_pendente);
-    }*/
-  }
-
-  /*bloqueia processos por tempo de cpu e reinicia o quantum*/
-  if(self->escalonador != simples){
-    if(self->processo_corrente != NULL && self->processo_corrente->quantum == 0){
-      if(self->ini_fila_proc_prontos != NULL){
-        so_muda_estado_processo(self, self->processo_corrente->id, bloqueado);
-        console_printf("(escalonador = %d)", self->escalonador);
-        self->ini_fila_proc_prontos = so_coloca_fila_pronto(self, self->processo_corrente);
-        self->ini_hist_proc = hst_atualiza_preempcoes(self->ini_hist_proc, self->processo_corrente->id);
-      }
-      self->processo_corrente->quantum = QUANTUM_INICIAL;
-    }
-  }
+      so_libera_terminal(self, self->processo_corrente->id_terminal/4);
+  /*a roda de tempo acompanha o relogio, antes de escalonar e de programar o
+    timer para o proximo a acordar*/
+  so_acorda_dorminhocos(self);
+  adiado_envelhece(&self->adiado, self->esc.agora, ESPERA_ADIADO);
+  so_executa_adiado(self, PRIO_URGENTE);
 
   /*Contabilidades - metricas: */
 
 }
 
-//funcao auxiliar temporaria para escalonamento
-processo_t* so_proximo_pronto(so_t* self);
+/*faz o trabalho adiado com prioridade ate prio_max, do mais para o menos
+  prioritario; retorna true se fez algum*/
+static bool so_executa_adiado(so_t *self, int prio_max)
+{
+  int tipo, dado;
+  bool fez = false;
+  while(adiado_proximo(&self->adiado, prio_max, &tipo, &dado)){
+    fez = true;
+    switch(tipo){
+      case ADIADO_TIQUE:
+        esc_tique(&self->esc, self->processo_corrente);
+        break;
+      /*E/S pendente: so as filas de espera dos terminais marcados, e so ate
+        o primeiro processo que o terminal ainda nao pode atender*/
+      case ADIADO_TECLADO:
+        for(int t = 0; t < TERMINAIS; t++)
+          if(dado & (1 << t))
+            so_atende_teclado(self, t);
+        break;
+      case ADIADO_TELA:
+        for(int t = 0; t < TERMINAIS; t++)
+          if(dado & (1 << t))
+            so_atende_tela(self, t);
+        break;
+      case ADIADO_OPERADOR: {
+        /*troca de escalonador pedida pelo operador*/
+        char nome[30];
+        if(console_pedido_escalonador(self->console, nome, sizeof(nome)))
+          so_define_escalonador(self, nome);
+        break;
+      }
+    }
+  }
+  return fez;
+}
+
 static void so_calcula_tempo_ocioso(so_t* self);
 
 static void so_escalona(so_t *self)
 {
   // escolhe o próximo processo a executar, que passa a ser o processo
   //   corrente; pode continuar sendo o mesmo de antes ou não
-  // t2: na primeira versão, escolhe um processo pronto caso o processo
-  //   corrente não possa continuar executando, senão deixa o mesmo processo.
-  //   depois, implementa um escalonador melhor
-  //console_printf("(so_escalona)");
-  if(self->processo_corrente != NULL && self->escalonador == prioridade){
-    if(self->ini_fila_proc_prontos == NULL || self->processo_corrente->prio > self->ini_fila_proc_prontos->prio){
-      self->ini_hist_proc = hst_atualiza_preempcoes(self->ini_hist_proc, self->processo_corrente->id);
-      self->ini_fila_proc_prontos = lst_retira(self->ini_fila_proc_prontos, self->processo_corrente->id);
-      self->ini_fila_proc_prontos = so_coloca_fila_pronto(self, self->processo_corrente);
-    }
-  }
+  // a escolha é do escalonador (ver escalonador.h)
   if(self->processo_corrente != NULL)
     console_printf("(escalona proc_corr estado: %d)", self->processo_corrente->estado);
   else
     console_printf("(escalona proc nulo)");
-  if(self->processo_corrente ==  NULL || self->processo_corrente->estado != pronto){
-    processo_t* prox_processo = so_proximo_pronto(self);
+  if(esc_deve_trocar(&self->esc, self->processo_corrente)){
+    processo_t* prox_processo = esc_proximo(&self->esc);
     if(prox_processo != NULL)
       console_printf("(prox_proc_id %d)", prox_processo->id);
     else
@@ -288,21 +411,63 @@ static void so_escalona(so_t *self)
       self->dispositivos_livres[prox_processo->id_terminal/4] = false;
       prox_processo->espera_terminal = 0;
     }
-    if(self->processo_corrente != NULL)
-      self->ini_hist_proc = hst_atualiza_preempcoes(self->ini_hist_proc, self->processo_corrente->id);
-    
+    processo_t* anterior = self->processo_corrente;
+    if(anterior != NULL && anterior != prox_processo){
+      esc_deixa_cpu(&self->esc, anterior);
+      Historico_processos* h = hst_busca(&self->hist, anterior->id);
+      if(h != NULL)
+        h->n_preempcoes++;
+      /*saiu da cpu sem bloquear nem morrer*/
+      if(anterior->estado == pronto)
+        self->n_preempcoes++;
+    }
+
     self->processo_corrente = prox_processo; //pode ser NULL
-    if(self->processo_corrente != NULL)
+    if(self->processo_corrente != NULL && self->processo_corrente != anterior){
       console_printf("id_proc_corr escalonado %d", self->processo_corrente->id);
+      esc_escolhido(&self->esc, self->processo_corrente);
+    }
+  }
+}
+
+/*relogio sob demanda: o timer so e programado se estiver parado e o
+  escalonador precisar de tiques (ver esc_precisa_tique) ou algum processo
+  estiver dormindo; com um so processo executavel, ou nenhum, ou com uma
+  politica sem quantum, o relogio nao interrompe, ou so interrompe quando o
+  proximo processo acorda*/
+static void so_programa_relogio(so_t *self)
+{
+  if(!RELOGIO_SOB_DEMANDA)
+    return;
+  int falta;
+  if(es_le(self->es, D_RELOGIO_TIMER, &falta) != ERR_OK){
+    console_printf("SO: problema no acesso ao timer");
+    self->erro_interno = true;
+    return;
+  }
+  /*o intervalo que o SO precisa: o quantum, se o escalonador precisa de
+    tiques, senao o tempo ate o proximo processo acordar; o timer so e
+    reprogramado se estiver parado ou se for interromper depois disso*/
+  int intervalo = 0;
+  if(esc_precisa_tique(&self->esc, self->processo_corrente))
+    intervalo = INTERVALO_INTERRUPCAO;
+  else if(roda_n(&self->roda) > 0){
+    intervalo = roda_proximo(&self->roda) * INTERVALO_INTERRUPCAO - self->esc.agora;
+    if(intervalo < 1)
+      intervalo = 1;
+  }
+  if(intervalo == 0 || (falta > 0 && falta <= intervalo))
+    return;
+  if(es_escreve(self->es, D_RELOGIO_TIMER, intervalo) != ERR_OK){
+    console_printf("SO: problema na programação do timer");
+    self->erro_interno = true;
   }
-    
-  //console_printf("id proc_corrente %d ", self->processo_corrente->id);
 }
 
 static int so_despacha(so_t *self)  /*Feito*/
 {
   // t2: se houver processo corrente, coloca o estado desse processo onde ele
-  //   será recuperado pela CPU (em CPU_END_PC etc e 59) e retorna 0,
+  //   será recuperado pela CPU (em CPU_END_PC etc) e retorna 0,
   //   senão retorna 1
   // o valor retornado será o valor de retorno de CHAMAC, e será colocado no 
   //   registrador A para o tratador de interrupção (ver trata_irq.asm).
@@ -310,11 +475,20 @@ static int so_despacha(so_t *self)  /*Feito*/
   /*Calculo do tempo ocioso*/
   so_calcula_tempo_ocioso(self);
 
+  /*os proximos acessos a memoria sao do processo escolhido*/
+  if(self->rastro != NULL){
+    if(self->processo_corrente != NULL)
+      rastro_define_pid(self->rastro, self->processo_corrente->id);
+    else
+      rastro_define_pid(self->rastro, RASTRO_SEM_PID);
+  }
+
   if(self->processo_corrente != NULL){
+    es_le(self->es, D_RELOGIO_INSTRUCOES, &self->processo_corrente->t_despacho);
     if(mem_escreve(self->mem, CPU_END_A, self->processo_corrente->A) != ERR_OK
       || mem_escreve(self->mem, CPU_END_PC, self->processo_corrente->PC) != ERR_OK
       || mem_escreve(self->mem, CPU_END_erro, self->processo_corrente->regErro) != ERR_OK
-      || mem_escreve(self->mem, 59, self->processo_corrente->X) != ERR_OK) {
+      || mem_escreve(self->mem, CPU_END_X, self->processo_corrente->X) != ERR_OK) {
       console_printf("SO: erro na escrita dos registradores do processo %d.", self->processo_corrente->id);
       self->erro_interno = true;
       return 1;
@@ -340,47 +514,94 @@ static void so_trata_reset(so_t *self);
 static void so_trata_irq_chamada_sistema(so_t *self);
 static void so_trata_irq_err_cpu(so_t *self);
 static void so_trata_irq_relogio(so_t *self);
+static void so_trata_irq_teclado(so_t *self);
+static void so_trata_irq_tela(so_t *self);
 static void so_trata_irq_desconhecida(so_t *self, int irq);
+static void so_atende_irq(so_t *self, int irq, int id_proc);
+static void so_atende_pic(so_t *self, int irq, int id_proc);
 
 static void so_trata_irq(so_t *self, int irq)
 {
   // verifica o tipo de interrupção que está acontecendo, e atende de acordo
   //console_printf("(trata_irq com irq %d)", irq);
-  Historico_processos* h = NULL;
+  int id_proc = -1;
   if(self->processo_corrente != NULL){
     console_printf("(irq proc_id %d)", self->processo_corrente->id);
-    h = hst_busca(self->ini_hist_proc, self->processo_corrente->id);
+    id_proc = self->processo_corrente->id;
   }
+  so_atende_irq(self, irq, id_proc);
+  so_atende_pic(self, irq, id_proc);
+  //console_printf("fim trata_irq com irq %d", irq);
+}
+
+/*atende uma interrupcao e contabiliza para o processo id_proc*/
+static void so_atende_irq(so_t *self, int irq, int id_proc)
+{
+  bool conhecida = true;
   switch (irq) {
     case IRQ_RESET:
       so_trata_reset(self);
-      if(h != NULL)
-        h->quant_irq[IRQ_RESET]++;
-      self->quant_irq[IRQ_RESET]++;
       break;
     case IRQ_SISTEMA:
       so_trata_irq_chamada_sistema(self);
-      if(h != NULL)
-        h->quant_irq[IRQ_SISTEMA]++;
-      self->quant_irq[IRQ_SISTEMA]++;
       break;
     case IRQ_ERR_CPU:
       so_trata_irq_err_cpu(self);
-      if(h != NULL)
-        h->quant_irq[IRQ_ERR_CPU]++;
-      self->quant_irq[IRQ_ERR_CPU]++;
       break;
     case IRQ_RELOGIO:
       so_trata_irq_relogio(self);
-      if(h != NULL)
-        h->quant_irq[IRQ_RELOGIO]++;
-      self->quant_irq[IRQ_RELOGIO]++;
+      break;
+    case IRQ_TECLADO:
+      so_trata_irq_teclado(self);
+      break;
+    case IRQ_TELA:
+      so_trata_irq_tela(self);
       break;
     default:
       so_trata_irq_desconhecida(self, irq);
-      self->quant_irq[TIPOS_IRQ]++;
+      conhecida = false;
+  }
+  /*contabiliza depois do atendimento, que pode realocar o vetor de
+    historicos (ao criar um processo)*/
+  if(conhecida){
+    Historico_processos* h = hst_busca(&self->hist, id_proc);
+    if(h != NULL)
+      h->quant_irq[irq]++;
+    self->quant_irq[irq]++;
+  }
+  else
+    self->quant_irq[TIPOS_IRQ]++;
+}
+
+/*se a interrupcao veio de um dispositivo, pelo PIC, aproveita a entrada no
+  SO para atender tambem os outros pedidos pendentes no PIC, e no final
+  encerra o atendimento (EOI) de todos*/
+static void so_atende_pic(so_t *self, int irq, int id_proc)
+{
+  int em_servico, pendentes, mascara;
+  if(es_le(self->es, D_PIC_EM_SERVICO, &em_servico) != ERR_OK
+     || es_le(self->es, D_PIC_PENDENTES, &pendentes) != ERR_OK
+     || es_le(self->es, D_PIC_MASCARA, &mascara) != ERR_OK){
+    console_printf("SO: problema no acesso ao PIC");
+    self->erro_interno = true;
+    return;
+  }
+  if((em_servico & (1 << irq)) == 0)
+    return;
+  int atendidas = 1 << irq;
+  pendentes &= ~mascara;
+  for(int i = 0; i < N_IRQ; i++){
+    if((pendentes & (1 << i)) == 0)
+      continue;
+    if(es_escreve(self->es, D_PIC_ACK, i) != ERR_OK)
+      continue;
+    so_atende_irq(self, i, id_proc);
+    atendidas |= 1 << i;
+  }
+  for(int i = 0; i < N_IRQ; i++){
+    if(atendidas & (1 << i))
+      es_escreve(self->es, D_PIC_EOI, i);
   }
-  //console_printf("fim trata_irq com irq %d", irq);
 }
 
 processo_t* so_cria_entrada_processo(so_t* self, int PC, int tam);
@@ -435,14 +656,11 @@ static void so_trata_reset(so_t *self)
   if (init != NULL) {
       self->processo_corrente = init;
       init->estado = pronto;
-      self->ini_fila_proc_prontos = so_coloca_fila_pronto(self, init);
-      self->ini_fila_proc = lst_insere_ordenado(self->ini_fila_proc, init->id, init->prio);
+      esc_insere(&self->esc, init);
   }
 
   console_printf("(init id_terminal %d)", self->processo_corrente->id_terminal);
-  int tempo;
-  es_le(self->es, D_RELOGIO_REAL, &tempo);
-  self->ini_hist_proc = hst_insere_ordenado(self->ini_hist_proc, init->id, tempo);
+  hst_insere(&self->hist, init->id, self->agora_real);
 
   //self->cont_processos++;     /*a quantidade de processos vira 1*/
 
@@ -477,12 +695,12 @@ static void so_trata_irq_err_cpu(so_t *self)
 // interrupção gerada quando o timer expira
 static void so_trata_irq_relogio(so_t *self)
 {
-  // rearma o interruptor do relógio e reinicializa o timer para a próxima interrupção
-  err_t e1, e2;
-  e1 = es_escreve(self->es, D_RELOGIO_INTERRUPCAO, 0); // desliga o sinalizador de interrupção
-  e2 = es_escreve(self->es, D_RELOGIO_TIMER, INTERVALO_INTERRUPCAO);
-  
-  if (e1 != ERR_OK || e2 != ERR_OK) {
+  // reinicializa o timer para a próxima interrupção; sob demanda, quem
+  //   programa é so_programa_relogio, se ainda precisar
+  // (o sinalizador de interrupção do relógio é desligado pelo controlador,
+  //   quando passa o pedido para o PIC)
+  if (!RELOGIO_SOB_DEMANDA
+      && es_escreve(self->es, D_RELOGIO_TIMER, INTERVALO_INTERRUPCAO) != ERR_OK) {
     console_printf("SO: problema da reinicialização do timer");
     self->erro_interno = true;
   }
@@ -491,8 +709,43 @@ static void so_trata_irq_relogio(so_t *self)
   //   um escalonador com quantum
   //console_printf("SO: interrupção do relógio (não tratada)");
 
-  if(self->escalonador != simples && self->processo_corrente != NULL)
-    self->processo_corrente->quantum--; 
+  /*o tique do escalonador e trabalho adiado, e os pedidos do operador sao
+    vistos em segundo plano a partir dele (e quando a cpu fica ociosa)*/
+  adiado_agenda(&self->adiado, ADIADO_TIQUE, ADIADO_TIQUE, 0, self->esc.agora);
+  adiado_agenda(&self->adiado, ADIADO_OPERADOR, ADIADO_OPERADOR, 0, self->esc.agora);
+}
+
+/*terminais (1<<t) com processo esperando na fila e com o dispositivo 'ok'
+  (TERM_TECLADO_OK ou TERM_TELA_OK) pronto*/
+static int so_terminais_prontos(so_t *self, int ok, lista_t filas[TERMINAIS])
+{
+  int terminais = 0;
+  for(int t = 0; t < TERMINAIS; t++){
+    int estado;
+    if(lista_n(&filas[t]) > 0
+       && es_le(self->es, (D_TERM_B - D_TERM_A) * t + ok, &estado) == ERR_OK
+       && estado != 0)
+      terminais |= 1 << t;
+  }
+  return terminais;
+}
+
+// chegou um caractere em algum teclado
+// a interrupção não diz de qual terminal; os que têm caractere e processo
+//   esperando são atendidos (e os processos desbloqueados) no trabalho adiado
+static void so_trata_irq_teclado(so_t *self)
+{
+  int terminais = so_terminais_prontos(self, TERM_TECLADO_OK, self->espera_teclado);
+  if(terminais != 0)
+    adiado_agenda(&self->adiado, ADIADO_TECLADO, ADIADO_TECLADO, terminais, self->esc.agora);
+}
+
+// alguma tela terminou de rolar ou de ser limpa e aceita caracteres
+static void so_trata_irq_tela(so_t *self)
+{
+  int terminais = so_terminais_prontos(self, TERM_TELA_OK, self->espera_tela);
+  if(terminais != 0)
+    adiado_agenda(&self->adiado, ADIADO_TELA, ADIADO_TELA, terminais, self->esc.agora);
 }
 
 // foi gerada uma interrupção para a qual o SO não está preparado
@@ -513,6 +766,53 @@ static void so_chamada_escr(so_t *self);
 static void so_chamada_cria_proc(so_t *self);
 static void so_chamada_mata_proc(so_t *self);
 static void so_chamada_espera_proc(so_t *self, processo_t* processo_pendente);
+static void so_chamada_bilhetes(so_t *self);
+static void so_chamada_tempo_real(so_t *self);
+static void so_chamada_cota(so_t *self);
+static void so_chamada_dorme(so_t *self);
+
+/*caminho rapido das chamadas de sistema: LE ou ESCR que pode ser feita na
+  hora, sem trabalho adiado de E/S, com o terminal livre e sem troca de processo pedida,
+  nao passa pelas pendencias nem pelo escalonador. So le e escreve na memoria
+  os registradores que a chamada usa (o descritor fica desatualizado, mas e
+  relido na proxima interrupcao), e a contabilizacao das instrucoes fica para
+  a proxima interrupcao (t_despacho nao muda). Retorna false, sem ter alterado
+  nada, se a chamada tiver que ir pelo caminho normal*/
+static bool so_chamada_rapida(so_t *self)
+{
+  processo_t* processo = self->processo_corrente;
+  if(processo == NULL || adiado_tem(&self->adiado, PRIO_ES)
+     || self->esc.troca || !self->dispositivos_livres[processo->id_terminal/4])
+    return false;
+  int id_chamada, estado, dado;
+  if(mem_le(self->mem, CPU_END_A, &id_chamada) != ERR_OK)
+    return false;
+  if(id_chamada == SO_LE){
+    if(es_le(self->es, processo->id_terminal + TERM_TECLADO_OK, &estado) != ERR_OK
+       || estado == 0
+       || es_le(self->es, processo->id_terminal + TERM_TECLADO, &dado) != ERR_OK)
+      return false;
+  }
+  else if(id_chamada == SO_ESCR){
+    if(es_le(self->es, processo->id_terminal + TERM_TELA_OK, &estado) != ERR_OK
+       || estado == 0
+       || mem_le(self->mem, CPU_END_X, &dado) != ERR_OK
+       || es_escreve(self->es, processo->id_terminal + TERM_TELA, dado) != ERR_OK)
+      return false;
+    dado = 0;
+  }
+  else
+    return false;
+  if(mem_escreve(self->mem, CPU_END_A, dado) != ERR_OK){
+    console_printf("SO: erro na escrita dos registradores do processo %d.", processo->id);
+    self->erro_interno = true;
+  }
+  Historico_processos* h = hst_busca(&self->hist, processo->id);
+  if(h != NULL)
+    h->quant_irq[IRQ_SISTEMA]++;
+  self->quant_irq[IRQ_SISTEMA]++;
+  return true;
+}
 
 static void so_trata_irq_chamada_sistema(so_t *self)
 {
@@ -523,23 +823,12 @@ static void so_trata_irq_chamada_sistema(so_t *self)
   int id_chamada = self->processo_corrente->A;
   console_printf("SO: chamada de sistema %d", id_chamada);
 
-  Historico_processos *h = NULL;
-  if(self->processo_corrente != NULL){
-    h = hst_busca(self->ini_hist_proc, self->processo_corrente->id);
-  }
-  else
-    return;
-
   switch (id_chamada) {
     case SO_LE:
       so_chamada_le(self);
-      h->quant_irq[IRQ_TECLADO]++;
-      self->quant_irq[IRQ_TECLADO]++;
       break;
     case SO_ESCR:
       so_chamada_escr(self);
-      h->quant_irq[IRQ_TELA]++;
-      self->quant_irq[IRQ_TELA]++;
       break;
     case SO_CRIA_PROC:
       so_chamada_cria_proc(self);
@@ -550,6 +839,18 @@ static void so_trata_irq_chamada_sistema(so_t *self)
     case SO_ESPERA_PROC:
       so_chamada_espera_proc(self, self->processo_corrente);
       break;
+    case SO_BILHETES:
+      so_chamada_bilhetes(self);
+      break;
+    case SO_TEMPO_REAL:
+      so_chamada_tempo_real(self);
+      break;
+    case SO_COTA:
+      so_chamada_cota(self);
+      break;
+    case SO_DORME:
+      so_chamada_dorme(self);
+      break;
     default:
       console_printf("SO: chamada de sistema desconhecida (%d)", id_chamada);
       // t2: deveria matar o processo
@@ -577,9 +878,11 @@ static void so_chamada_le(so_t *self)
     console_printf("SO: problema no acesso ao estado do teclado");
     return;
   }
-  if (estado != 0){
+  if (estado == 0){
     self->processo_corrente->espera_terminal = 1;
-    so_muda_estado_processo(self, self->processo_corrente->id, bloqueado);
+    so_bloqueia_processo(self, self->processo_corrente,
+                         &self->espera_teclado[self->processo_corrente->id_terminal / 4],
+                         bloq_terminal);
     return;
   } 
     // como não está saindo do SO, a unidade de controle não está executando seu laço.
@@ -621,10 +924,12 @@ static void so_chamada_escr(so_t *self)
     console_printf("SO: problema no acesso ao estado da tela");
     return;
   }
-  if (estado != 0){
+  if (estado == 0){
     console_printf("espera terminal = 2 estado = %d", estado);
     self->processo_corrente->espera_terminal = 2;
-    so_muda_estado_processo(self, self->processo_corrente->id, bloqueado);
+    so_bloqueia_processo(self, self->processo_corrente,
+                         &self->espera_tela[self->processo_corrente->id_terminal / 4],
+                         bloq_terminal);
     return;
   } 
     // como não está saindo do SO, a unidade de controle não está executando seu laço.
@@ -663,48 +968,38 @@ static void so_chamada_cria_proc(so_t *self)
   //ender_proc = self->regX;
   int ender_proc;
   ender_proc = self->processo_corrente->X;
-  processo_t *processo;
+  /*pid do processo criado, ou -1 se qualquer passo falhar (nome invalido,
+    programa que nao carrega, tabela de processos cheia)*/
+  int resultado = -1;
 
   char nome[100];
   if (copia_str_da_mem(100, nome, self->mem, ender_proc)) {
-    //programa_t *prog = so_carrega_programa(self, nome, processo);
     programa_t *prog = so_carrega_programa(self, nome);
-    processo = so_cria_entrada_processo(self, prog_end_carga(prog), prog_tamanho(prog));
-    //processo = inicializa_processo(processo, self->cont_processos, prog_end_carga(prog), prog_tamanho(prog));
+    processo_t *processo = NULL;
+    if(prog != NULL)
+      processo = so_cria_entrada_processo(self, prog_end_carga(prog), prog_tamanho(prog));
     if(processo != NULL){
-      /*int ind_proc = encontra_indice_processo(self->processos, processo->id);
-      if(ind_proc != -1){
-        self->processos[ind_proc] = *processo;*/       /*guarda dados do processo criado no SO*/
-      //self->cont_processos++;     /*contém a quantidade de processos*/
       processo->erro = ERR_OK;
       processo->regErro = 0;
-      //} 
-      self->ini_fila_proc_prontos = so_coloca_fila_pronto(self, processo);
-      console_printf("(id_proc: %d, ini_proc %d)", processo->id, self->ini_fila_proc_prontos->id);
-      self->ini_fila_proc = lst_insere_ordenado(self->ini_fila_proc, processo->id, processo->prio);
-      int tempo;
-      es_le(self->es, D_RELOGIO_REAL, &tempo);
-      self->ini_hist_proc = hst_insere_ordenado(self->ini_hist_proc, processo->id, tempo);
-    }
-    else{
-      //cpu_interrompe(self->cpu, IRQ_ERR_CPU);
-      processo->erro = ERR_OP_INV;
-      processo->regErro = 1;
+      /*os filhos do init comecam um grupo novo, os outros herdam o do criador*/
+      if(self->processo_corrente->id != 0)
+        processo->grupo = self->processo_corrente->grupo;
+      esc_insere(&self->esc, processo);
+      console_printf("(id_proc: %d)", processo->id);
+      Historico_processos* h = hst_insere(&self->hist, processo->id, self->agora_real);
+      if(h != NULL)
+        h->grupo = processo->grupo;
+      resultado = processo->id;
     }
-    prog_destroi(prog);
+    if(prog != NULL)
+      prog_destroi(prog);
   }
-  // deveria escrever -1 (se erro) ou o PID do processo criado (se OK) no reg A
+  // escreve -1 (se erro) ou o PID do processo criado (se OK) no reg A
   //   do processo que pediu a criação
-  if(processo->regErro == 1){
-    self->processo_corrente->A = -1;
-  }
-  else{
-    self->processo_corrente->A = processo->id;
-  }
+  self->processo_corrente->A = resultado;
 }
 
 void so_calculo_e_impressao_metricas(so_t* self, int tempo);
-static void so_libera_espera_proc(so_t *self, int id_proc_morrendo);
 
 // implementação da chamada se sistema SO_MATA_PROC
 // mata o processo com pid X (ou o processo corrente se X é 0)
@@ -718,32 +1013,41 @@ static void so_chamada_mata_proc(so_t *self)
   int id_proc_a_matar = self->processo_corrente->id;
   console_printf("(id proc_a_matar %d)", id_proc_a_matar);
 
-  int indice = encontra_indice_processo(self->processos, id_proc_a_matar);
-  Historico_processos* h = hst_busca(self->ini_hist_proc, id_proc_a_matar);
+  processo_t* processo = tp_busca(self->tabela, id_proc_a_matar);
+  Historico_processos* h = hst_busca(&self->hist, id_proc_a_matar);
   /*calcula tempo de vida do processo*/
-  int tempo;
-  es_le(self->es, D_RELOGIO_REAL, &tempo);
-  h->tempo_vida = tempo - h->tempo_vida;
+  h->tempo_vida = self->agora_real - h->tempo_vida;
+  h->t_morte = self->agora_real;
   /*nao encontrou processo com esse id*/
-  if(indice == -1){
+  if(processo == NULL){
     console_printf("SO: processo de id %d nao encontrado para SO_MATA_PROC", id_proc_a_matar);
     //self->regA = -1;
     self->processo_corrente->A = -1;
   }
 
-  so_muda_estado_processo(self, id_proc_a_matar, morto);
+  /*copia os dados para o historico antes de mudar o estado, porque o
+    descritor do processo morto e liberado*/
+  h->instrucoes = self->processo_corrente->instrucoes;
+  h->t_executavel = self->processo_corrente->t_executavel;
+  h->bilhetes = self->processo_corrente->bilhetes;
+  h->n_surtos = self->processo_corrente->n_exec;
+  h->erro_previsao = self->processo_corrente->erro_previsao;
+  int agora;
+  es_le(self->es, D_RELOGIO_INSTRUCOES, &agora);
+  h->retorno = agora - self->processo_corrente->t_criacao;
+  h->tr = self->processo_corrente->tr;
+  h->cota = self->processo_corrente->cota;
+  h->n_estrangulamentos = self->processo_corrente->n_estrangulamentos;
 
   if(self->processo_corrente != NULL){
-    self->dispositivos_livres[self->processo_corrente->id_terminal/4] = true;    //libera
-    self->processo_corrente = NULL;
+    so_libera_terminal(self, self->processo_corrente->id_terminal/4);
   }
-
-  so_libera_espera_proc(self, id_proc_a_matar);
+  so_muda_estado_processo(self, id_proc_a_matar, morto);
+  self->processo_corrente = NULL;
 
   /*Impressao das metricas finais*/
   if(id_proc_a_matar == 0){
-    es_le(self->es, D_RELOGIO_REAL, &tempo);
-    so_calculo_e_impressao_metricas(self, tempo);
+    so_calculo_e_impressao_metricas(self, self->agora_real);
   }
 
   self->regA = 0; //tudo ok
@@ -757,21 +1061,86 @@ static void so_chamada_espera_proc(so_t *self, processo_t* processo)
   // ainda sem suporte a processos, retorna erro -1
   /*console_printf("SO: SO_ESPERA_PROC não implementada");
   self->regA = -1;*/
-  processo->estado = bloqueado;
-  if(lst_busca(self->ini_fila_proc_prontos, processo->id) != NULL){
-    //console_printf("(proc %d esta em proc_prontos)", processo->id);
-    self->ini_fila_proc_prontos = lst_retira(self->ini_fila_proc_prontos, processo->id);
-    if(self->ini_fila_proc_prontos != NULL)
-      console_printf("(proc_pronto id %d)", self->ini_fila_proc_prontos->id);   /*Teste*/
+  /*se o processo esperado ja morreu, nao precisa esperar*/
+  /*o descritor do processo morto e liberado, entao nao ser encontrado e
+    o mesmo que ja ter morrido*/
+  processo_t* esperado = tp_busca(self->tabela, processo->X);
+  if(esperado == NULL){
+    processo->A = 0;
+    return;
   }
+  so_bloqueia_processo(self, processo, &esperado->esperando_fim, bloq_processo);
 
   /*int ind = encontra_indice_processo(self->processos, processo_pendente->X);
   if(ind == -1 || self->processos[ind].estado == morto){    //Se processo morto ou nao existe mais, entao pode parar de esperar
     processo_pendente->estado = pronto;
-    self->ini_fila_proc_prontos = so_coloca_fila_pronto(self, processo_pendente);
+    so_coloca_fila_pronto(self, processo_pendente);
   }*/
 }
 
+// implementação da chamada se sistema SO_BILHETES
+// altera os bilhetes do processo chamador para o valor em X
+static void so_chamada_bilhetes(so_t *self)
+{
+  processo_t *processo = self->processo_corrente;
+  if (processo->X < 1 || processo->X > BILHETES_MAX) {
+    processo->A = -1;
+    return;
+  }
+  processo->bilhetes = processo->X;
+  processo->passo = PASSADA_UM / processo->X;
+  processo->A = 0;
+}
+
+// implementação da chamada se sistema SO_TEMPO_REAL
+// em X está o endereço do período e do orçamento
+static void so_chamada_tempo_real(so_t *self)
+{
+  processo_t *processo = self->processo_corrente;
+  int periodo, orcamento;
+  if (mem_le(self->mem, processo->X, &periodo) != ERR_OK
+      || mem_le(self->mem, processo->X + 1, &orcamento) != ERR_OK
+      || !esc_tempo_real(&self->esc, processo, periodo, orcamento)) {
+    console_printf("SO: processo %d nao admitido em tempo real", processo->id);
+    processo->A = -1;
+    return;
+  }
+  processo->A = 0;
+}
+
+// implementação da chamada se sistema SO_COTA
+// limita o processo chamador a X instruções por janela
+static void so_chamada_cota(so_t *self)
+{
+  processo_t *processo = self->processo_corrente;
+  if (!esc_cota(&self->esc, processo, processo->X)) {
+    processo->A = -1;
+    return;
+  }
+  processo->A = 0;
+}
+
+// implementação da chamada se sistema SO_DORME
+// bloqueia o processo chamador por X intervalos do relógio, na roda de tempo
+static void so_chamada_dorme(so_t *self)
+{
+  processo_t *processo = self->processo_corrente;
+  if (processo->X < 0) {
+    processo->A = -1;
+    return;
+  }
+  processo->A = 0;
+  if (processo->X == 0) return;
+  // a roda tem que estar no instante atual antes de inserir
+  so_acorda_dorminhocos(self);
+  // acorda no primeiro fim de intervalo depois do tempo pedido
+  int acorda = (self->esc.agora + (processo->X + 1) * INTERVALO_INTERRUPCAO - 1)
+               / INTERVALO_INTERRUPCAO;
+  roda_insere(&self->roda, &processo->no_dorme, acorda);
+  processo->bloqueio = bloq_dorme;
+  so_muda_estado_processo(self, processo->id, bloqueado);
+}
+
 // ---------------------------------------------------------------------
 // CARGA DE PROGRAMA {{{1
 // ---------------------------------------------------------------------
@@ -790,11 +1159,10 @@ static programa_t* so_carrega_programa(so_t *self, char *nome_do_executavel)
   int end_ini = prog_end_carga(prog);
   int end_fim = end_ini + prog_tamanho(prog);
 
-  for (int end = end_ini; end < end_fim; end++) {
-    if (mem_escreve(self->mem, end, prog_dado(prog, end)) != ERR_OK) {
-      console_printf("Erro na carga da memória, endereco %d\n", end);
-      return NULL;
-    }
+  if (prog_carrega(prog, self->mem) != ERR_OK) {
+    console_printf("Erro na carga da memória, endereços %d-%d\n", end_ini, end_fim);
+    prog_destroi(prog);
+    return NULL;
   }
 
   console_printf("SO: carga de '%s' em %d-%d", nome_do_executavel, end_ini, end_fim);
@@ -830,131 +1198,166 @@ static bool copia_str_da_mem(int tam, char str[tam], mem_t *mem, int ender)
 }
 // vim: foldmethod=marker
 
-float so_calcula_prioridade(processo_t* processo){
-  int t_exec = QUANTUM_INICIAL - processo->quantum;
-  float prioridade = (processo->prio + t_exec/QUANTUM_INICIAL) / 2;
-  return prioridade;
-}
-
-Lista_processos* so_coloca_fila_pronto(so_t* self, processo_t* processo){
-  float prio = 0.5; //simples e round-robin
-  console_printf("(escalonador atual = %d)", self->escalonador);
-  switch (self->escalonador){
-  case simples:
-    self->ini_fila_proc_prontos = lst_adicionar_final(self->ini_fila_proc_prontos, processo->id, processo->prio);
-    break;
-  case round_robin:
-    self->ini_fila_proc_prontos = lst_adicionar_final(self->ini_fila_proc_prontos, processo->id, processo->prio);
-    break;
-  case prioridade:
-    prio = so_calcula_prioridade(processo);
-    self->ini_fila_proc_prontos = lst_insere_ordenado(self->ini_fila_proc_prontos, processo->id, prio);
-  default:
-    console_printf("SO: escalonador nao encontrado");
-    break;
-  }  
-  return self->ini_fila_proc_prontos;
-}
-
-int so_busca_entrada_tabela(so_t* self){
-  for(int i = 0; i < MAX_PROCESSOS; i++){
-    if(self->processos[i].estado == morto){
-      return i;
-    }
-  }
-  return -1; //tabela cheia
-}
-
 processo_t* so_cria_entrada_processo(so_t* self, int PC, int tam) {
-    int i = so_busca_entrada_tabela(self);
-    if (i == -1) {
-        console_printf("SO: tabela de processos cheia");
+    /*a tabela cresce conforme a necessidade, so falha se faltar memoria*/
+    processo_t* processo = tp_aloca(self->tabela, self->cont_processos);
+    if (processo == NULL) {
+        console_printf("SO: sem memoria para a tabela de processos");
+        return NULL;
+    }
+    if (inicializa_processo(processo, self->cont_processos, PC, tam) == NULL) {
+        tp_libera(self->tabela, processo);
         return NULL;
     }
-    int id = self->cont_processos++;
-    inicializa_processo(&self->processos[i], id, PC, tam);
-    self->processos[i].estado = pronto;
-    if(self->processos[i].id == 0)
+    self->cont_processos++;
+    processo->estado = pronto;
+    esc_cria(&self->esc, processo);
+    es_le(self->es, D_RELOGIO_INSTRUCOES, &processo->t_criacao);
+    if(processo->id == 0)
       console_printf("id eh 0");
     else
       console_printf("id diferente de zero");
-    return &self->processos[i];
-}
-
-processo_t* so_proximo_pendente(so_t* self, int quant_bloq){
-  Lista_processos* l = self->ini_fila_proc;
-  int proc_bloq = 0; 
-  while(l != NULL){
-    if(l->estado == bloqueado){
-      proc_bloq++;
-      console_printf("quant %d proc_bloq %d", quant_bloq, proc_bloq);
-      if(quant_bloq < proc_bloq){
-        int indice = encontra_indice_processo(self->processos, l->id);
-        return &self->processos[indice];
-      }
-    }
-    l = l->prox;
-  }
-  console_printf("nao ha proc pendente");
-  return NULL; //nao ha processos pendentes/bloqueados
+    return processo;
 }
 
-processo_t* so_proximo_pronto(so_t* self){
-  Lista_processos* l = self->ini_fila_proc_prontos;
-  if(l != NULL){
-    int indice = encontra_indice_processo(self->processos, l->id);
-    if(indice != -1)
-      return &self->processos[indice];
-  }
-  return NULL; //nao ha processos prontos
+/*soma ao processo corrente as instrucoes executadas desde o despacho; le
+  tambem o relogio real, usado pela contabilidade de toda a interrupcao*/
+static void so_contabiliza_execucao(so_t* self){
+  int agora;
+  es_le(self->es, D_RELOGIO_INSTRUCOES, &agora);
+  es_le(self->es, D_RELOGIO_REAL, &self->agora_real);
+  esc_define_agora(&self->esc, agora);
+  processo_t* processo = self->processo_corrente;
+  if(processo == NULL)
+    return;
+  int executadas = agora - processo->t_despacho;
+  processo->t_despacho = agora;
+  processo->instrucoes += executadas;
+  esc_executou(&self->esc, processo, executadas);
 }
 
 static void so_muda_estado_processo(so_t* self, int id_proc, estado_proc est){
-  altera_estado_proc_tabela(self->processos, id_proc, est);
-  self->ini_fila_proc = lst_altera_estado(self->ini_fila_proc, id_proc, est);
+  processo_t* processo = tp_busca(self->tabela, id_proc);
+  if(processo != NULL)
+    processo->estado = est;
 
-  Historico_processos *h = hst_busca(self->ini_hist_proc, id_proc);
+  Historico_processos *h = hst_busca(&self->hist, id_proc);
   if(h != NULL){
-    int tempo;
-    es_le(self->es, D_RELOGIO_REAL, &tempo);
-    h->tempo_estado[est] += tempo - h->tempo_desde_ult_estado;
-    h->tempo_desde_ult_estado = tempo;
+    h->tempo_estado[est] += self->agora_real - h->tempo_desde_ult_estado;
+    h->tempo_desde_ult_estado = self->agora_real;
+  }
+
+  if(processo != NULL){
+    /*sai da fila de espera, sem alocar, ou da roda de tempo*/
+    if(est != bloqueado && processo->fila_espera != NULL){
+      lista_retira(processo->fila_espera, &processo->no_espera);
+      processo->fila_espera = NULL;
+    }
+    if(est != bloqueado)
+      roda_retira(&self->roda, &processo->no_dorme);
+    if(est == pronto)
+      esc_desbloqueia(&self->esc, processo);
+    else if(est == bloqueado)
+      esc_bloqueia(&self->esc, processo, processo->bloqueio);
+    else
+      esc_morre(&self->esc, processo);
+  }
+  if(est == morto && processo != NULL){
+    /*acorda quem esperava por ele, e o descritor volta para a tabela*/
+    so_libera_espera_proc(self, processo);
+    tp_libera(self->tabela, processo);
+  }
+}
+
+/*bloqueia o processo na fila de espera do recurso que ele espera*/
+static void so_bloqueia_processo(so_t* self, processo_t* processo, lista_t* fila, motivo_bloqueio motivo){
+  processo->bloqueio = motivo;
+  processo->fila_espera = fila;
+  lista_insere(fila, &processo->no_espera);
+  so_muda_estado_processo(self, processo->id, bloqueado);
+}
+
+/*desbloqueia os processos na fila de espera do processo que esta morrendo*/
+static void so_libera_espera_proc(so_t *self, processo_t* morrendo){
+  no_lista_t* no;
+  while((no = lista_primeiro(&morrendo->esperando_fim)) != NULL){
+    processo_t* processo = LISTA_DONO(no, processo_t, no_espera);
+    so_muda_estado_processo(self, processo->id, pronto);
   }
+}
+
+/*o processo que usava o terminal deixou de usar; quem espera por ele pode
+  ter ficado sem ser atendido enquanto o terminal estava ocupado*/
+static void so_libera_terminal(so_t* self, int terminal){
+  if(self->dispositivos_livres[terminal])
+    return;
+  self->dispositivos_livres[terminal] = true;
+  adiado_agenda(&self->adiado, ADIADO_TECLADO, ADIADO_TECLADO, 1 << terminal, self->esc.agora);
+  adiado_agenda(&self->adiado, ADIADO_TELA, ADIADO_TELA, 1 << terminal, self->esc.agora);
+}
 
-  if(est == pronto){
-    self->ini_fila_proc_prontos = so_coloca_fila_pronto(self, self->processo_corrente);
+/*acorda os processos que terminaram de dormir (SO_DORME), avancando a roda
+  de tempo ate o intervalo do relogio atual; e chamada a cada entrada no SO
+  (fora do caminho rapido), entao a roda nunca fica atrasada*/
+static void so_acorda_dorminhocos(so_t* self){
+  no_roda_t* no;
+  while((no = roda_vence(&self->roda, self->esc.agora / INTERVALO_INTERRUPCAO)) != NULL){
+    processo_t* processo = LISTA_DONO(no, processo_t, no_dorme);
+    so_muda_estado_processo(self, processo->id, pronto);
   }
-  else{ /*bloqueado ou morto*/
-    self->ini_fila_proc_prontos = lst_retira(self->ini_fila_proc_prontos, id_proc); 
-    if(est == morto){
-      self->ini_fila_proc = lst_retira(self->ini_fila_proc, id_proc);
+}
+
+/*atende os processos esperando o teclado do terminal, em ordem, enquanto
+  houver dado para ler*/
+static void so_atende_teclado(so_t* self, int terminal){
+  lista_t* fila = &self->espera_teclado[terminal];
+  while(lista_n(fila) > 0 && self->dispositivos_livres[terminal]){
+    processo_t* processo = LISTA_DONO(lista_primeiro(fila), processo_t, no_espera);
+    int estado_term, dado;
+    if(es_le(self->es, processo->id_terminal + TERM_TECLADO_OK, &estado_term) != ERR_OK){
+      console_printf("SO: teclado nao disponivel");
+      return;
+    }
+    if(estado_term == 0)
+      return;
+    if(es_le(self->es, processo->id_terminal + TERM_TECLADO, &dado) != ERR_OK){
+      console_printf("SO: problema no acesso ao teclado");
+      return;
     }
+    processo->A = dado;
+    so_muda_estado_processo(self, processo->id, pronto);
   }
 }
 
-static void so_libera_espera_proc(so_t *self, int id_proc_morrendo){
-  for(int i = 0; i < MAX_PROCESSOS; i++){ 
-    if(self->processos[i].X == id_proc_morrendo){
-      /*altera_estado_proc_tabela(self->processos, self->processos[i].id, pronto);
-      self->ini_fila_proc = lst_altera_estado(self->ini_fila_proc, self->processos[i].id, pronto);
-      processo_t *processo = lst_busca(self->ini_fila_proc, self->processos[i].id);
-      self->ini_fila_proc_prontos = so_coloca_fila_pronto(self, processo);*/
-      so_muda_estado_processo(self, self->processos[i].id, pronto);
+/*atende os processos esperando a tela do terminal, em ordem, enquanto ela
+  aceitar caracteres*/
+static void so_atende_tela(so_t* self, int terminal){
+  lista_t* fila = &self->espera_tela[terminal];
+  while(lista_n(fila) > 0 && self->dispositivos_livres[terminal]){
+    processo_t* processo = LISTA_DONO(lista_primeiro(fila), processo_t, no_espera);
+    int estado_term;
+    if(es_le(self->es, processo->id_terminal + TERM_TELA_OK, &estado_term) != ERR_OK){
+      console_printf("SO: tela nao disponivel");
+      return;
+    }
+    if(estado_term == 0)
+      return;
+    if(es_escreve(self->es, processo->id_terminal + TERM_TELA, processo->X) != ERR_OK){
+      console_printf("SO: problema no acesso à tela");
+      return;
     }
+    processo->A = 0;
+    so_muda_estado_processo(self, processo->id, pronto);
   }
 }
 
 static void so_calcula_tempo_ocioso(so_t* self){
   if(self->processo_corrente == NULL){
-    int tempo;
-    es_le(self->es, D_RELOGIO_REAL, &tempo);
-    self->momento_sist_ocioso = tempo;
+    self->momento_sist_ocioso = self->agora_real;
   }
   else{
     if(self->momento_sist_ocioso != 0){
-      int tempo;
-      es_le(self->es, D_RELOGIO_REAL, &tempo);
-      self->tempo_ocioso_total += tempo - self->momento_sist_ocioso;
+      self->tempo_ocioso_total += self->agora_real - self->momento_sist_ocioso;
       self->momento_sist_ocioso = 0;
     }
   }
@@ -973,13 +1376,64 @@ void so_calculo_e_impressao_metricas(so_t* self, int tempo){
   }
 
   console_printf("\nForam %d preempcoes no total", self->n_preempcoes);
+  console_printf("Trabalho adiado: %d pedidos, %d juntados a um pendente, %d executados",
+                 self->adiado.n_agendados, self->adiado.n_juntados, self->adiado.n_executados);
+
+  /*justica: a taxa de progresso de um processo eh a fracao da cpu que
+    recebeu enquanto podia executar (cpu / tempo pronto ou executando);
+    o indice de Jain das taxas vai de 1/n (so um progrediu) a 1 (todos
+    progrediram igualmente)*/
+  double total = 0, soma_taxas = 0, soma_quadrados = 0;
+  for(int i = 0; i < self->cont_processos; i++){
+    Historico_processos *h = hst_busca(&self->hist, i);
+    double taxa = h->t_executavel > 0 ? (double)h->instrucoes / h->t_executavel : 0;
+    total += h->instrucoes;
+    soma_taxas += taxa;
+    soma_quadrados += taxa * taxa;
+  }
+  if(soma_quadrados > 0)
+    console_printf("Indice de justica (Jain) da cpu: %.3f", soma_taxas * soma_taxas / (self->cont_processos * soma_quadrados));
+
+  /*o processo 0 (init) vive o tempo todo, fica fora da media*/
+  double soma_retorno = 0;
+  for(int i = 1; i < self->cont_processos; i++){
+    soma_retorno += hst_busca(&self->hist, i)->retorno;
+  }
+  if(self->cont_processos > 1)
+    console_printf("Tempo medio de retorno: %.0f instrucoes", soma_retorno / (self->cont_processos - 1));
+
+  /*uso da cpu por grupo de processos (ver SO_CRIA_PROC); o grupo eh o pid
+    de um processo, entao os totais ficam num vetor indexado pelo grupo*/
+  int *n_grupo = calloc(self->cont_processos, sizeof(int));
+  int *instrucoes_grupo = calloc(self->cont_processos, sizeof(int));
+  if(n_grupo != NULL && instrucoes_grupo != NULL){
+    for(int i = 0; i < self->cont_processos; i++){
+      Historico_processos *h = hst_busca(&self->hist, i);
+      n_grupo[h->grupo]++;
+      instrucoes_grupo[h->grupo] += h->instrucoes;
+    }
+    for(int g = 0; g < self->cont_processos; g++){
+      if(n_grupo[g] > 0)
+        console_printf("Grupo %d: %d processos, %d instrucoes (%.1f%% da cpu)", g, n_grupo[g],
+                       instrucoes_grupo[g], total > 0 ? 100 * instrucoes_grupo[g] / total : 0);
+    }
+  }
+  free(n_grupo);
+  free(instrucoes_grupo);
+
+  /*metricas da classe de tempo real e do escalonador*/
+  esc_metricas(&self->esc, &self->hist);
 
   for(int i = 0; i < self->cont_processos; i++){
-    Historico_processos *h = hst_busca(self->ini_hist_proc, i);
+    Historico_processos *h = hst_busca(&self->hist, i);
     console_printf("Processo %d: ", i);
     console_printf("Tempo de retorno/vida: %d", h->tempo_vida);
+    console_printf("Tempo de retorno: %d instrucoes", h->retorno);
     console_printf("Numero de preempcao: %d", h->n_preempcoes);
-    console_printf("Em media, o tempo de resposta foi %d \n", h->tempo_espera/h->quant_estado[pronto]);
+    console_printf("Instrucoes executadas: %d (%.1f%% da cpu)", h->instrucoes, total > 0 ? 100 * h->instrucoes / total : 0);
+    console_printf("Taxa de progresso: %.2f", h->t_executavel > 0 ? (double)h->instrucoes / h->t_executavel : 0);
+    if(h->quant_estado[pronto] > 0)
+      console_printf("Em media, o tempo de resposta foi %d \n", h->tempo_espera/h->quant_estado[pronto]);
     for(int j = 0; j < 3; j++){
       console_printf("Estado %s", estado_nome(j));
       console_printf("Entrou %d vezes nesse estado", h->quant_estado[j]);
@@ -14,11 +14,26 @@ typedef struct fila_processo Fila_processo;
 #include "cpu.h"
 #include "es.h"
 #include "console.h" // só para uma gambiarra
+#include "rastro.h"
 
 so_t *so_cria(cpu_t *cpu, mem_t *mem, es_t *es, console_t *console);
 void so_destroi(so_t *self);
 
-typedef enum { simples, round_robin, prioridade} escalonador_atual;
+// define o rastro de acessos à memória, para o SO informar o pid do
+//   processo que vai executar a cada despacho (NULL se não tem rastro)
+void so_define_rastro(so_t *self, rastro_t *rastro);
+
+// funções para salvar e recuperar o estado do SO em um instantâneo
+//   (seguem o protocolo f_salva_t e f_restaura_t de instantaneo.h)
+void *so_salva(void *self);
+bool so_restaura(void *self, void *estado);
+
+// troca o escalonador de processos pelo de nome 'nome' (ver os arquivos
+//   esc_*.c); retorna false, sem trocar, se não existir escalonador com esse
+//   nome
+// o escalonador também pode ser trocado pelo operador, com o comando 'S' da
+//   console
+bool so_define_escalonador(so_t *self, char *nome);
 
 // Chamadas de sistema
 // Uma chamada de sistema é realizada colocando a identificação da
@@ -64,6 +79,10 @@ typedef enum { simples, round_robin, prioridade} escalonador_atual;
 //   a ser executado pelo novo processo estão na memória do processo
 //   que realiza esta chamada, a partir da posição em X até antes
 //   da posição que contém um valor 0.
+// o processo criado pertence ao mesmo grupo de processos que o criador,
+//   exceto os criados pelo init, que começam cada um um grupo novo (com a
+//   identificação igual ao seu pid); o escalonador grupos divide a cpu
+//   igualmente entre os grupos
 // retorna em A: pid do processo criado, ou código de erro negativo
 #define SO_CRIA_PROC   7
 
@@ -79,6 +98,47 @@ typedef enum { simples, round_robin, prioridade} escalonador_atual;
 // retorna sem bloquear, com erro, se não existir processo com esse pid
 #define SO_ESPERA_PROC 9
 
+// altera o número de bilhetes do processo chamador, usado pelos escalonadores
+//   loteria e passada (todo processo é criado com BILHETES_PADRAO bilhetes)
+// recebe em X o novo número de bilhetes, entre 1 e BILHETES_MAX
+// retorna em A: 0 se OK ou um código de erro negativo
+#define SO_BILHETES    10
+
+#define BILHETES_PADRAO 100
+#define BILHETES_MAX    1000
+
+// coloca o processo chamador na classe de tempo real, ou o tira dela
+// recebe em X o endereço de dois valores: o período e o orçamento de cpu por
+//   período, ambos em interrupções do relógio; período 0 volta à classe normal
+// a cada período o processo pode executar pelo orçamento, até o fim do
+//   período (o prazo); entre os processos de tempo real executa o de prazo
+//   mais próximo (EDF), e qualquer um deles tem preferência sobre os processos
+//   normais, seja qual for o escalonador
+// retorna em A: 0 se OK ou um código de erro negativo, se os valores forem
+//   inválidos ou se os processos de tempo real passariam a precisar de mais
+//   de 100% da cpu
+#define SO_TEMPO_REAL  11
+
+// limita a cpu usada pelo processo chamador
+// recebe em X o número máximo de instruções que o processo pode executar a
+//   cada janela de JANELA_COTA interrupções do relógio; 0 tira o limite
+// o processo que esgota a cota sai dos processos prontos até o início da
+//   próxima janela, seja qual for o escalonador (o que executou além da cota
+//   é descontado da janela seguinte); não vale para os processos de tempo
+//   real, que já têm um orçamento
+// retorna em A: 0 se OK ou um código de erro negativo
+#define SO_COTA        12
+
+#define JANELA_COTA    20
+
+// bloqueia o processo chamador por um tempo, sem usar a cpu
+// recebe em X o tempo, em intervalos do relógio (de INTERVALO_INTERRUPCAO
+//   instruções, ver so.c); o processo volta a ficar pronto no primeiro fim
+//   de intervalo depois desse tempo
+// retorna em A: 0 se OK ou um código de erro negativo, se o tempo for
+//   negativo (com tempo 0 retorna na hora)
+#define SO_DORME       13
+
 #define TIPOS_IRQ 6
 
 #define QUANTUM_INICIAL 5
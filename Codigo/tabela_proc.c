@@ -0,0 +1,113 @@
+// tabela_proc.c
+// tabela de processos
+// simulador de computador
+// so25b
+
+#include "tabela_proc.h"
+#include "slab.h"
+#include "mapa.h"
+
+#include <stdlib.h>
+
+struct tabela_proc_t {
+  slab_t *descritores;
+  mapa_t *pids;        // pid -> descritor
+  lista_t todos;       // os processos, em ordem de criação
+};
+
+tabela_proc_t *tp_cria(void)
+{
+  tabela_proc_t *self = malloc(sizeof(*self));
+  if (self == NULL) return NULL;
+  self->descritores = slab_cria(sizeof(processo_t));
+  self->pids = mapa_cria();
+  if (self->descritores == NULL || self->pids == NULL) {
+    tp_destroi(self);
+    return NULL;
+  }
+  lista_inicializa(&self->todos);
+  return self;
+}
+
+void tp_destroi(tabela_proc_t *self)
+{
+  if (self->descritores != NULL) slab_destroi(self->descritores);
+  if (self->pids != NULL) mapa_destroi(self->pids);
+  free(self);
+}
+
+processo_t *tp_aloca(tabela_proc_t *self, int id)
+{
+  processo_t *proc = slab_aloca(self->descritores);
+  if (proc == NULL) return NULL;
+  if (!mapa_insere(self->pids, id, proc)) {
+    slab_libera(self->descritores, proc);
+    return NULL;
+  }
+  proc->id = id;
+  lista_inicializa_no(&proc->no_todos);
+  lista_insere(&self->todos, &proc->no_todos);
+  return proc;
+}
+
+void tp_libera(tabela_proc_t *self, processo_t *proc)
+{
+  lista_retira(&self->todos, &proc->no_todos);
+  mapa_retira(self->pids, proc->id);
+  slab_libera(self->descritores, proc);
+}
+
+processo_t *tp_busca(tabela_proc_t *self, int id)
+{
+  return mapa_busca(self->pids, id);
+}
+
+int tp_n(tabela_proc_t *self)
+{
+  return slab_n(self->descritores);
+}
+
+processo_t *tp_primeiro(tabela_proc_t *self)
+{
+  no_lista_t *no = lista_primeiro(&self->todos);
+  return no == NULL ? NULL : LISTA_DONO(no, processo_t, no_todos);
+}
+
+processo_t *tp_proximo(processo_t *proc)
+{
+  no_lista_t *no = lista_proximo(&proc->no_todos);
+  return no == NULL ? NULL : LISTA_DONO(no, processo_t, no_todos);
+}
+
+// o estado é a lista de processos e o tamanho do estado do alocador,
+//   seguidos do estado do alocador e do mapa
+
+typedef struct {
+  lista_t todos;
+  int tam_slab;
+} tp_estado_t;
+
+int tp_tam_estado(tabela_proc_t *self)
+{
+  return sizeof(tp_estado_t) + slab_tam_estado(self->descritores)
+         + mapa_tam_estado(self->pids);
+}
+
+void tp_salva(tabela_proc_t *self, void *estado)
+{
+  tp_estado_t *e = estado;
+  e->todos = self->todos;
+  e->tam_slab = slab_tam_estado(self->descritores);
+  slab_salva(self->descritores, e + 1);
+  mapa_salva(self->pids, (char *)(e + 1) + e->tam_slab);
+}
+
+bool tp_restaura(tabela_proc_t *self, void *estado)
+{
+  tp_estado_t *e = estado;
+  // o mapa primeiro, é a única parte que pode falhar
+  if (!mapa_restaura(self->pids, (char *)(e + 1) + e->tam_slab)) return false;
+  self->todos = e->todos;
+  slab_restaura(self->descritores, e + 1);
+  return true;
+}
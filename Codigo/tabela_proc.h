@@ -0,0 +1,57 @@
+// tabela_proc.h
+// tabela de processos
+// simulador de computador
+// so25b
+
+#ifndef TABELA_PROC_H
+#define TABELA_PROC_H
+
+// Os descritores de processo são alocados em blocos (ver slab.h), e a tabela
+//   cresce conforme a necessidade; o número de processos só é limitado pela
+//   memória. Um mapa (ver mapa.h) associa o pid ao descritor.
+// Criar, destruir e buscar um processo pelo pid são O(1).
+// O descritor de um processo não muda de endereço enquanto o processo
+//   existe.
+// Os processos existentes ficam também numa lista intrusiva (ver lista.h),
+//   em ordem de criação, para serem percorridos com tp_primeiro() e
+//   tp_proximo() sem passar pelas entradas livres.
+
+#include "processo.h"
+
+typedef struct tabela_proc_t tabela_proc_t;
+
+// cria uma tabela vazia
+tabela_proc_t *tp_cria(void);
+
+// destrói a tabela e todos os descritores
+void tp_destroi(tabela_proc_t *self);
+
+// aloca um descritor para o processo com pid 'id' (não inicializado, a não
+//   ser o id e o encadeamento na lista de processos); retorna NULL se faltar
+//   memória
+processo_t *tp_aloca(tabela_proc_t *self, int id);
+
+// libera o descritor do processo
+void tp_libera(tabela_proc_t *self, processo_t *proc);
+
+// retorna o descritor do processo com pid 'id', ou NULL se não existir
+processo_t *tp_busca(tabela_proc_t *self, int id);
+
+// número de processos na tabela
+int tp_n(tabela_proc_t *self);
+
+// o primeiro processo da tabela, ou NULL se ela estiver vazia
+processo_t *tp_primeiro(tabela_proc_t *self);
+
+// o processo criado depois de 'proc', ou NULL se ele for o último
+processo_t *tp_proximo(processo_t *proc);
+
+// funções para salvar e recuperar a tabela em um instantâneo (o estado é
+//   salvo em 'estado', que deve ter tp_tam_estado() bytes); os descritores
+//   voltam aos mesmos endereços
+// tp_restaura retorna false, sem alterar a tabela, se faltar memória
+int tp_tam_estado(tabela_proc_t *self);
+void tp_salva(tabela_proc_t *self, void *estado);
+bool tp_restaura(tabela_proc_t *self, void *estado);
+
+#endif // TABELA_PROC_H
@@ -33,6 +33,10 @@ struct terminal_t {
   enum { normal, rolando, limpando } estado_saida;
   // posicao do caractere que está sendo movido durante uma rolagem
   int pos_rolagem;
+  // pedidos de interrupção ainda não passados ao PIC: do teclado, quando
+  //   chega um caractere, e da tela, quando ela volta a aceitar caracteres
+  bool int_teclado;
+  bool int_tela;
 };
 
 
@@ -48,6 +52,8 @@ terminal_t *terminal_cria(int tam_linha)
   assert(self->saida != NULL && self->entrada != NULL);
 
   self->estado_saida = normal;
+  self->int_teclado = false;
+  self->int_tela = false;
 
   return self;
 }
@@ -81,6 +87,7 @@ void terminal_insere_char(terminal_t *self, char ch)
   if (tam >= self->tam_linha - 2) return;
   p[tam] = ch;
   p[tam + 1] = '\0';
+  self->int_teclado = true;
 }
 
 static bool terminal_pode_imprimir(terminal_t *self)
@@ -113,6 +120,7 @@ static err_t terminal_imprime(terminal_t *self, char ch)
 void terminal_limpa_saida(terminal_t *self)
 {
   self->saida[0] = '\0';
+  if (self->estado_saida != normal) self->int_tela = true;
   self->estado_saida = normal;
 }
 
@@ -126,7 +134,10 @@ static void terminal_atualiza_rolagem(terminal_t *self)
   self->pos_rolagem++;
   p[self->pos_rolagem] = ' ';
   // se chegou no final da string, volta ao estado normal
-  if (ch == '\0') self->estado_saida = normal;
+  if (ch == '\0') {
+    self->estado_saida = normal;
+    self->int_tela = true;
+  }
 }
 
 static void terminal_atualiza_limpeza(terminal_t *self)
@@ -138,7 +149,10 @@ static void terminal_atualiza_limpeza(terminal_t *self)
   memmove(p, p + 1, tam);
   tam--;
   // volta ao estado normal se era o último
-  if (tam <= 0) self->estado_saida = normal;
+  if (tam <= 0) {
+    self->estado_saida = normal;
+    self->int_tela = true;
+  }
 }
 
 // altera a string de saída em 1 caractere, se estiver rolando ou limpando
@@ -148,6 +162,24 @@ void terminal_tictac(terminal_t *self)
   terminal_atualiza_limpeza(self);
 }
 
+bool terminal_pede_interrupcao(terminal_t *self, irq_t *pirq)
+{
+  if (self->int_teclado) {
+    *pirq = IRQ_TECLADO;
+  } else if (self->int_tela) {
+    *pirq = IRQ_TELA;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void terminal_interrupcao_aceita(terminal_t *self, irq_t irq)
+{
+  if (irq == IRQ_TECLADO) self->int_teclado = false;
+  if (irq == IRQ_TELA) self->int_tela = false;
+}
+
 char *terminal_txt_entrada(terminal_t *self)
 {
   return self->entrada;
@@ -190,3 +222,32 @@ err_t terminal_escrita(void *disp, int id, int valor)
   if (subdisp != TERM_TELA) return ERR_OP_INV;
   return terminal_imprime(self, valor);
 }
+
+// o estado salvo é a estrutura seguida do texto das linhas de entrada e saída
+void *terminal_salva(void *disp)
+{
+  terminal_t *self = disp;
+  int tam = self->tam_linha + 1;
+  terminal_t *copia = malloc(sizeof(*copia) + 2 * tam);
+  assert(copia != NULL);
+  *copia = *self;
+  char *txt = (char *)(copia + 1);
+  memcpy(txt, self->entrada, tam);
+  memcpy(txt + tam, self->saida, tam);
+  return copia;
+}
+
+bool terminal_restaura(void *disp, void *estado)
+{
+  terminal_t *self = disp;
+  terminal_t *copia = estado;
+  int tam = self->tam_linha + 1;
+  char *txt = (char *)(copia + 1);
+  memcpy(self->entrada, txt, tam);
+  memcpy(self->saida, txt + tam, tam);
+  self->estado_saida = copia->estado_saida;
+  self->pos_rolagem = copia->pos_rolagem;
+  self->int_teclado = copia->int_teclado;
+  self->int_tela = copia->int_tela;
+  return true;
+}
@@ -32,9 +32,15 @@
 //   saída chamando terminal_txt_entrada ou terminal_txt_saida. a console insere
 //   caracteres digitados no terminal chamando terminal_insere_char, e limpa a
 //   linha de saída com terminal_limpa_saida.
+//
+// o terminal pede uma interrupção (IRQ_TECLADO) quando recebe um caractere
+//   digitado e outra (IRQ_TELA) quando a saída termina de rolar ou de ser
+//   limpa e volta a aceitar caracteres. o pedido fica registrado até que o
+//   controlador o passe para o PIC (ver terminal_pede_interrupcao).
 
 #include <stdbool.h>
 #include "err.h"
+#include "irq.h"
 
 typedef struct terminal_t terminal_t;
 
@@ -65,10 +71,24 @@ void terminal_limpa_saida(terminal_t *self);
 // esta função deve ser chamada periodicamente
 void terminal_tictac(terminal_t *self);
 
+// retorna true se o terminal tem um pedido de interrupção pendente, e
+//   coloca em *pirq a interrupção pedida (IRQ_TECLADO tem prioridade)
+// (para uso pelo controlador, que deve chamar terminal_interrupcao_aceita
+//   quando o pedido for registrado no PIC)
+bool terminal_pede_interrupcao(terminal_t *self, irq_t *pirq);
+
+// retira o pedido de interrupção 'irq', que já foi registrado no PIC
+void terminal_interrupcao_aceita(terminal_t *self, irq_t irq);
+
 // Funções para implementar o protocolo de acesso a um dispositivo pelo
 //   controlador de E/S
 // Devem seguir o protocolo f_leitura_t e f_escrita_t declarados em es.h
 err_t terminal_leitura(void *disp, int id, int *pvalor);
 err_t terminal_escrita(void *disp, int id, int valor);
 
+// funções para salvar e recuperar o estado do terminal em um instantâneo
+//   (seguem o protocolo f_salva_t e f_restaura_t de instantaneo.h)
+void *terminal_salva(void *self);
+bool terminal_restaura(void *self, void *estado);
+
 #endif // TERMINAL_H
@@ -9,15 +9,9 @@
 ;   vai ser executado novamente na próxima interrupção)
 
 trata_int
-        ; quando atende uma interrupção, a CPU salva seu estado na memória, coloca
-        ;   o código da interrupção (IRQ) em A e desvia para este endereço.
-        ; infelizmente, a CPU não salva o valor de X, então colocamos o X no end 59
-        ;   (que parece estar livre), para que o SO consiga encontrar
-
-salvax  define 59
-        trax         ; A <=> X
-        armm salvax  ; mem[59] = X
-        trax         ; A <=> X
+        ; quando atende uma interrupção, a CPU salva seu estado na memória
+        ;   (incluindo o X), coloca o código da interrupção (IRQ) em A e desvia
+        ;   para este endereço.
         ; chamac chama a função C do SO passando A como argumento
         chamac
         ; o valor de retorno da função chamada é colocado em A
@@ -26,10 +20,7 @@ salvax  define 59
         ;   início da memória
         desvnz suspende
         ; o SO deve ter colocado na memória, nos endereços CPU_END_PC etc os
-        ;   valores dos registradores que serão recuperados por RETI, e deve
-        ;   ter colocado o valor de X (que RETI não recupera) no endereço 59
-        cargm salvax
-        trax
+        ;   valores dos registradores que serão recuperados por RETI
         reti
 suspende
         para